@@ -98,6 +98,12 @@ Read the input files and rewrite them in accordance with the options.
 Like the B<source>, with all output files organised beneath a specified directory
 mirroring their original structure.  
 
+To spin several configurations of the same files, run B<spin> once for each
+configuration, with its B<--define> and B<--undef> options in an I<argsfile>
+for B<--file> and its own B<--dir>, e.g.
+
+    for cfg in A B C; do coan spin --file $cfg.args --dir out/$cfg -R src; done
+
 =item B<symbols> [OPTION...] [I<file>...] [I<directory>...]
 
 Select references of preprocessor symbols from the input files in accordance with 
@@ -133,6 +139,22 @@ and report them on the standard output in accordance with the options.
 Select preprocessor directives from the input files in accordance with the 
 options and report them on the standard output in accordance with the options.
 
+=item B<merge> [OPTION...] I<report>...
+
+Combine the reports that a listing command wrote on the standard output when
+run with B<--shard 1/>I<N> through B<--shard >I<N>B</>I<N>, and write them on
+the standard output just as a single run of the listing command would have
+written them. The I<report> files must be given in the order of the shards.
+
+=item B<precompile-config> [OPTION...] I<cfgfile>
+
+Digest the B<--define> and B<--undef> options, as any command would before
+reading its input files, and save the resulting configuration of symbols in
+the binary file I<cfgfile>. A later command given B<--config> I<cfgfile>
+restores the configuration without parsing and digesting the options again.
+The only other valid options are B<--file>, B<--config>,
+B<--config-header>, B<--gag>, B<--verbose> and B<--stats>.
+
 =back
 
 =head1 OPTIONS
@@ -192,6 +214,27 @@ Process only input files that have one of the file extensions I<ext1>,I<ext2>...
 A file extension is the terminal segment of a filename that immediately follows 
 the final '.'.
 
+=item B<--exclude> I<glob>
+
+Do not process input files whose names match the pattern I<glob>, in which
+B<*> matches any characters except '/', B<?> any one character except '/',
+B<[>I<...>B<]> any one of the bracketed characters or ranges, B<[!>I<...>B<]>
+any character not bracketed, and B<\> escapes the next character. A I<glob>
+that does not contain '/' is matched against the last element of a file's
+path, so B<--exclude '*_test.c'> excludes every file with that suffix.
+Otherwise an absolute I<glob> is matched against the whole real path and a
+relative I<glob> against every trailing sequence of elements of the path.
+The option may be repeated, and a file that matches any I<glob> is excluded,
+including a file named explicitly.
+
+=item B<--exclude-dir> I<glob>
+
+Do not look for input files beneath directories whose names match the pattern
+I<glob>, as for B<--exclude>. So B<--exclude-dir .git --exclude-dir build
+--exclude-dir 'src/third_party'> prunes those subtrees. An excluded directory
+is never opened, so nothing beneath it is read or even examined. The option may
+be repeated.
+
 =item B<-g>[B<p>|B<i>|B<w>|B<e>|B<a>], B<--gag> [B<progress> | B<info> | B<warning> | B<error> | B<abend>]
 
 Suppress diagnostics no worse than [B<progress> | B<info> | B<warning> | B<error> | B<abend>].
@@ -236,6 +279,146 @@ risk.
 Apart from #-directives, input is to be treated as Plain Old Data. C or C++ 
 comments and quotations will not be parsed. 
 
+=item B<--max-expansion> I<N>[B<K>|B<M>]
+
+Limit the size of any macro-expansion to I<N> bytes, or I<N> kilobytes with
+suffix B<K>, or I<N> megabytes with suffix B<M>. An expansion that would exceed
+the limit is abandoned with a warning and the reference is treated as unknown.
+The default is 4196 bytes.
+
+=item B<--stats>
+
+At exit, write a summary of the run to the standard error. The summary gives
+the wall and CPU time spent discovering input files, reading lines, evaluating
+directives, expanding macros and writing output; the numbers of lines read,
+of directives of each type and of B<#if>s resolved and left unresolved; the
+hits, misses and invalidations of the cache of evaluated symbol references;
+the number of symbols of each provenance; and the peak resident memory.
+
+=item B<--trace> I<FILE>
+
+Write a timeline of the run to I<FILE> in the Chrome trace-event format, which
+can be viewed in B<chrome://tracing> or Perfetto. The timeline shows the
+processing of each input file, the opening and closing of files, each
+evaluation of a directive that takes at least the B<--trace-threshold> and
+each macro expansion, with its invocation.
+
+=item B<--trace-threshold> I<USECS>
+
+With B<--trace>, show only evaluations of directives that take at least
+I<USECS> microseconds. The default is 100.
+
+=item B<--profile-symbols> I<N>
+
+At exit, write to the standard error the I<N> symbols whose references cost
+most time to evaluate. For each symbol the report gives the time spent
+evaluating its references, exclusive and inclusive of the references nested in
+them; the number of its references evaluated; the number of its
+macro-expansions and the size of the largest; and the number of times its
+cached references were invalidated by changes in its configuration or in the
+configuration of symbols it depends on.
+
+=item B<--profile-files> I<N>
+
+At exit, write to the standard error the I<N> input files that took longest to
+process. For each file the report gives the time spent processing it; the
+numbers of lines, directives and macro-expansions read from it; the number of
+bytes of source output for it; and whether processing of it was abandoned.
+
+=item B<--profile-files-csv> I<CSVFILE>
+
+At exit, write the record of every input file that is reported by
+B<--profile-files> to I<CSVFILE>, as comma-separated values.
+
+=item B<--file-budget-ms> I<MS>
+
+If an input file has taken more than I<MS> milliseconds to process, stop
+evaluating its directives. A warning is given and the rest of the B<#if>,
+B<#ifdef>, B<#ifndef> and B<#elif> directives in the file are left unresolved,
+as if they depended on symbols that could not be evaluated. This bounds the
+time that any one file can take.
+
+=item B<--expansion-budget> I<N>
+
+If an input file has incurred more than I<N> macro-expansions, stop evaluating
+its directives, as for B<--file-budget-ms>. Nested expansions count against the
+budget, and an expansion that would exceed it is abandoned, leaving its
+directive unresolved.
+
+=item B<--progress>
+
+Report progress at intervals while input files are processed. Each report is
+written to the standard error and gives the number of files processed out of the
+number to be processed, the rates of files, lines and megabytes processed per
+second and the estimated time to completion. The estimate is based on the
+cumulative size of the files processed. Reports are made every 5 seconds, or as
+specified by B<--progress-interval>.
+
+On Unix-like hosts, whether or not this option is given, the summary that is
+written by B<--stats> is written to the standard error whenever the B<coan>
+process receives B<SIGUSR1>. It includes the phase times only with B<--stats>.
+
+=item B<--progress-interval> I<SECS>
+
+Report progress every I<SECS> seconds. Implies B<--progress>.
+
+=item B<--shard> I<I>B</>I<N>
+
+Process only the I<I>-th of I<N> shards of the input files. The input files,
+in the order in which they are processed, are partitioned into I<N>
+consecutive shards of about equal total size. The partition depends only on
+the names and sizes of the input files, so I<N> runs of a command with
+B<--shard 1/>I<N> through B<--shard >I<N>B</>I<N> process each file exactly
+once. A shard may have no files. The reports of the runs of a listing
+command can be combined with the B<merge> command. B<--shard> implies
+B<--keepgoing>, so that every shard processes all of its files, as a single
+run with B<--keepgoing> would.
+
+=item B<--compile-db> I<file>
+
+Add the source files of the entries of the compilation database I<file>, in
+the JSON format of F<compile_commands.json>, to the input files, and process
+each of them under the B<--define> and B<--undef> options of the commandline
+followed by the B<-D> and B<-U> options in the B<arguments> or B<command> of
+its entry. As with the compiler, B<-D>I<sym> is taken as B<-D>I<sym>B<=1>
+and the last B<-D> or B<-U> option for a symbol wins. An option of the entry
+overrides any B<--define> or B<--undef> option for the same symbol on the
+commandline.
+Files whose entries have the same B<-D> and B<-U> options share a
+configuration that is digested only once. A file that has several entries is
+processed under the configuration of the first, with a warning if the others
+differ. Files that do not exist are ignored with a warning. Input files that
+are given otherwise are processed under the options of the commandline. Not
+valid with B<--index>.
+
+=item B<--config> I<cfgfile>
+
+Restore the configuration of symbols saved in I<cfgfile> by the
+B<precompile-config> command, with the effect of the B<--define> and
+B<--undef> options from which it was digested. It must precede any
+B<--define> or B<--undef> option, which then add to the configuration.
+I<cfgfile> is rejected by any version of coan other than the one that wrote
+it.
+
+=item B<--expansion-cache> I<file>
+
+Keep in I<file> the macro-expansions of references of globally configured
+symbols, with their explanations for B<--explain>, and recall them in later
+runs instead of expanding the references again. An expansion is kept only if
+it depends on nothing but the B<--define> and B<--undef> options and raised no
+diagnostics. I<file> is keyed by the B<--define> and B<--undef> options, the
+B<--max-expansion> limit and the version of coan, and its contents are
+discarded when the key changes. Not valid with B<--compile-db>.
+
+=item B<--config-header> I<header>
+
+Digest each B<#define> and B<#undef> directive in the file I<header> as the
+equivalent B<--define> or B<--undef> option, in their order in I<header>.
+Comments and line-continuations are observed. Other directives, including
+conditional directives, are ignored, so every B<#define> and B<#undef> in
+I<header> takes effect. This reads a large generated F<config.h> much faster
+than the same options in a B<--file>.
+
 =back
 
 =head2 OPTIONS FOR THE source COMMAND
@@ -257,7 +440,16 @@ If you wish to preserve the original files with the B<--replace> option, use the
 B<--backup> option as well.
 
 If the names of the input files are read from B<stdin>, the filenames are 
-delimited by whitespace unless enclosed in double-quotes.
+delimited by whitespace unless enclosed in double-quotes, or by NUL with
+B<--null>.
+
+=item B<-0>, B<--null>
+
+The names of the input files read from the standard input are delimited by NUL
+characters, as written by B<find -print0> or B<git ls-files -z>, and may
+contain any other characters, including whitespace and double-quotes. The
+names are read in large blocks. Valid only when the names of the input files
+are read from the standard input.
 
 =item B<-b>I<suffix>, B<--backup> I<suffix>
 
@@ -351,6 +543,21 @@ equated with the path prefix I<pathname> of any input file. This enables any
 common prefix of all input files to be deleted from all the outout files under
 I<dir> if desired.   
 
+=item B<--index> I<file>
+
+Record in I<file> each input file that is spun without error, with its size,
+modification time and a hash of its contents, and the symbols on which its
+output depends: those it tests, defines or undefines, together with the symbols
+that contribute to their definitions. The B<--define> and B<--undef> options of
+the run are recorded too. A later spin with the same I<file> skips, without
+reading, every input file that is unchanged, whose output file still exists
+and that depends on none of the symbols whose B<--define> or B<--undef> option
+has been added, removed or changed. If any other option that affects the
+output, such as B<--line>, B<--discard>, B<--conflict>, B<--implicit> or
+B<--max-expansion>, has changed, no input file is skipped and I<file> is
+rebuilt. If I<file> is not a valid index it is rebuilt with a warning. Not
+valid with B<--compile-db>.
+
 =back
 
 
@@ -633,6 +840,24 @@ Report the source file and line number of each listed occurrence.
 
 =back
 
+=head2 OPTIONS FOR THE merge COMMAND
+
+=over
+
+=item B<-o>, B<--once-only>
+
+=item B<-L>, B<--locate>
+
+Each of these options must be given if and only if it was given to the
+listing command that wrote the reports.
+
+=item B<--exit-codes> I<RC1>[B<,>I<RC2>...]
+
+The exit codes of the shard runs. They are combined in the exit code of
+B<merge> as the diagnostics of a single run would be.
+
+=back
+
 =head1 DIAGNOSTICS
 
 Diagnostics written to stderr are classified by severity. Each diagnostic includes
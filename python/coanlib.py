@@ -286,6 +286,37 @@ def run_noerr(cmd):
 		bail('*** Command failed: \"' + cmd + '\": ' + \
 			os.strerror(retcode))
 	
+def same_run(rc, report, expected_rc, expected_report,
+		kind, expected_kind):
+	''' Say whether a run of coan with exit code `rc` that wrote
+	`report` matches a run with exit code `expected_rc` that wrote
+	`expected_report`. If not, report an error that calls the runs
+	`kind` and `expected_kind` '''
+	if rc != expected_rc:
+		error('*** {0} exit code {1} differs from {2} exit code {3}'.format(
+			kind,rc,expected_kind,expected_rc))
+		return False
+	if slurp_file(report) != slurp_file(expected_report):
+		error('*** {0} report \"{1}\" differs from {2} report \"{3}\"'.format(
+			kind,report,expected_kind,expected_report))
+		return False
+	return True
+	
+def get_stats(text):
+	''' Return a dictionary of the items of the run summary in `text`,
+	or None if there is no run summary '''
+	lines = text.splitlines()
+	for i in range(len(lines)):
+		if lines[i].endswith(' stats:'):
+			stats = {}
+			for line in lines[i + 1:]:
+				if not line.startswith('  '):
+					break
+				(name,value) = line.split()
+				stats[name] = value
+			return stats
+	return None
+	
 def is_exe(path):
 	''' Say whether a path is an executable file '''
 	return os.path.isfile(path) and os.access(path, os.X_OK)
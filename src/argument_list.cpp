@@ -46,46 +46,48 @@ void argument_list::read(chewer<CharSeq> & chew)
 {
 	_defect = argument_list::none;
 	if (*chew == '(') {
-		unique_ptr<vector<string>> args(new vector<string>) ;
+		params_type args;
 		chew(+1,greyspace);
 		string arg;
 		while (chew) {
 			arg = canonical<macro_argument>(chew);
 			if (*chew == ',') {
-				args->push_back(arg);
 				if (arg.empty()) {
 					_defect = argument_list::empty_param;
 				}
+				args.push_back(std::move(arg));
 				arg.clear();
 				++chew;
 			} else if (*chew == ')') {
 				if (arg.empty()) {
-					if (args->size()) {
+					if (args.size()) {
 						_defect = argument_list::empty_param;
 					}
 				} else {
-					args->push_back(arg);
+					args.push_back(std::move(arg));
 					arg.clear();
 				}
 				break;
 			}
 		}
 		if (!arg.empty()) {
-			args->push_back(arg);
+			args.push_back(std::move(arg));
 		}
 		if (!chew || *chew != ')') {
 			_defect = argument_list::unclosed;
 		} else {
 			++chew;
 		}
-		if (args->size()) {
-			_params.reset(args.release());
-			_expand_flags.reset(new vector<bool>(_params->size(),false));
+		if (args.size()) {
+			_params = std::move(args);
+			_null = false;
+			_expand_flags.assign(_params.size(),false);
 		}
 		return;
 	}
-	_params.reset();
-    _expand_flags.reset();
+	_params.clear();
+	_null = true;
+    _expand_flags.clear();
 }
 
 template
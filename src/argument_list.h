@@ -81,8 +81,7 @@ struct argument_list : innards::parameter_list_base {
     /// Equality
 	bool operator==(argument_list const & other) const {
 		return parameter_list_base::operator==(other) &&
-            (_expand_flags == other._expand_flags ||
-                *_expand_flags == *other._expand_flags);
+            _expand_flags == other._expand_flags;
 	}
 
     /// Inequality
@@ -110,8 +109,8 @@ struct argument_list : innards::parameter_list_base {
      * \return True iff the `n`th member of the `argument_list` exists.
      */
 	bool set_expandable(size_t n, bool expandable = false)  {
-        if (_expand_flags && n < _expand_flags->size()) {
-            (*_expand_flags)[n] = expandable;
+        if (n < _expand_flags.size()) {
+            _expand_flags[n] = expandable;
             return true;
         }
         return false;
@@ -125,8 +124,7 @@ struct argument_list : innards::parameter_list_base {
      *  is eligible for expansion.
      */
 	bool is_expandable(size_t n) const {
-        return _expand_flags && n < _expand_flags->size() ?
-            (*_expand_flags)[n] : false;
+        return n < _expand_flags.size() ? _expand_flags[n] : false;
 	}
 
 private:
@@ -147,9 +145,10 @@ private:
 	}
 
     /** The `n`th flag indicates whether the nth argument is eligible
-        for macro expansion.
+        for macro expansion. Held in place, like the arguments, for
+        short lists.
     */
-    std::shared_ptr<std::vector<bool>> _expand_flags;
+    small_vector<char,4> _expand_flags;
 
 	/** \brief Append an argument to the argument list.
      *
@@ -0,0 +1,582 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include "options.h"
+#include "chew.h"
+#include "directive.h"
+#include "expression_parser.h"
+#include "integer_constant.h"
+#include "reference.h"
+#include "reference_cache.h"
+#include "symbol.h"
+#include "name_trie.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*! \file coan_bench.cpp
+    This file implements the `coan_bench` microbenchmark program.
+
+    `coan_bench [--filter TEXT] [--min-time SECS] [--out FILE]` runs the
+    microbenchmarks whose names contain `TEXT` (all, by default) and writes
+    their results as JSON to `FILE` (the standard output, by default).
+
+    `coan_bench compare BASELINE [CURRENT] [--threshold PCT]` compares
+    the results in `CURRENT` (or of a fresh run, if `CURRENT` is not given)
+    with those in `BASELINE` and exits with status 1 if any benchmark has
+    become slower by more than `PCT` percent (default 10) or makes
+    more heap allocations per operation.
+
+    The program is built by `make coan_bench` in the `src` directory.
+*/
+
+using namespace std;
+
+namespace {
+
+/// Heap allocations made since the counters were last reset.
+unsigned long long alloc_count = 0;
+/// Bytes heap-allocated since the counters were last reset.
+unsigned long long alloc_bytes = 0;
+
+/// Results of benchmarks are accumulated here to keep them live.
+volatile size_t sink = 0;
+
+/// The result of one microbenchmark
+struct result
+{
+	/// The name of the benchmark
+	string name;
+	/// The number of operations timed
+	unsigned long long iterations;
+	/// Mean nanoseconds per operation
+	double ns_per_op;
+	/// Mean heap allocations per operation
+	double allocs_per_op;
+	/// Mean bytes heap-allocated per operation
+	double bytes_per_op;
+};
+
+/// Settings from the commandline
+struct settings
+{
+	/// Only run benchmarks whose names contain this text.
+	string filter;
+	/// Minimum seconds for which to time each benchmark.
+	double min_time = 0.25;
+	/// File to which to write JSON results, or empty for `cout`.
+	string out;
+	/// Percentage slowdown that `compare` reports as a regression.
+	double threshold = 10.0;
+};
+
+/** \brief Time an operation.
+ *
+ *	\tparam Op A nullary callable type.
+ *	\param name The name of the benchmark.
+ *	\param op The operation to be timed.
+ *	\param min_time The minimum number of seconds for which to repeat `op`.
+ *	\return The `result` of the final, long enough, batch of repetitions.
+ */
+template<typename Op>
+result measure(string const & name, Op op, double min_time)
+{
+	using clock = chrono::steady_clock;
+	op();
+	unsigned long long n = 1;
+	for ( ;; ) {
+		alloc_count = alloc_bytes = 0;
+		auto start = clock::now();
+		for (unsigned long long i = 0; i < n; ++i) {
+			op();
+		}
+		double secs = chrono::duration<double>(clock::now() - start).count();
+		if (secs >= min_time) {
+			return result{	name,n,secs * 1e9 / n,
+							double(alloc_count) / n,
+							double(alloc_bytes) / n};
+		}
+		unsigned long long next = secs > 0 ?
+			(unsigned long long)(n * min_time * 1.2 / secs) : n * 100;
+		n = next > n * 100 ? n * 100 : next > n ? next : n * 2;
+	}
+}
+
+/// Realistic C source text for the `chewer` benchmarks.
+string const & c_text()
+{
+	static string text;
+	if (text.empty()) {
+		string const fragment =
+			"/* Return the number of bytes in the header, or -1 on error.\n"
+			" * The header is validated against the magic number first.\n"
+			" */\n"
+			"static int header_size(struct header const * hdr, size_t len)\n"
+			"{\n"
+			"    // Cope with truncated input\n"
+			"    if (len < sizeof(*hdr) || hdr->magic != 0x7f454c46UL) {\n"
+			"        fprintf(stderr,\"bad header: %s\\n\",\"too short\");\n"
+			"        return -1;\n"
+			"    }\n"
+			"    char sep = '\\t';\n"
+			"    unsigned long total = hdr->count * 16 + (hdr->flags & 3);\n"
+			"    return total > INT_MAX ? -1 : (int)total; /* fits */\n"
+			"}\n"
+			"\n";
+		for (int i = 0; i < 64; ++i) {
+			text += fragment;
+		}
+	}
+	return text;
+}
+
+/** \brief Directive lines of a directive-dense header, each positioned
+ *	after its `#` and any greyspace, as `directive_base::eval()` gets them.
+ */
+vector<parse_buffer> const & directive_lines()
+{
+	static vector<parse_buffer> lines;
+	if (lines.empty()) {
+		for (char const * line : {
+				"ifndef CONFIG_H", "define CONFIG_H", "include <stddef.h>",
+				"if defined(__GNUC__) && __GNUC__ >= 4",
+				"define API __attribute__((visibility(\"default\")))",
+				"elif defined(_MSC_VER)", "define API __declspec(dllexport)",
+				"else", "define API", "endif", "ifdef HAVE_STDINT_H",
+				"include <stdint.h>", "endif", "undef ASSERT",
+				"pragma once", "line 100 \"config.h\"",
+				"error Unsupported platform", "endif" }) {
+			lines.emplace_back(string(line) + '\n');
+		}
+	}
+	return lines;
+}
+
+/// Tokenize `text` as `find_any_in()` does when searching for names.
+size_t tokenize(bool cxx, string & text)
+{
+	size_t tokens = 0;
+	chewer<string> chew(cxx,text);
+	while (chew) {
+		chew(greyspace);
+		size_t mark = size_t(chew);
+		chew(name);
+		if (size_t(chew) == mark) {
+			chew(number_space);
+		}
+		if (size_t(chew) == mark) {
+			chew(literal_space);
+		}
+		if (size_t(chew) == mark) {
+			chew(punctuation);
+		}
+		if (size_t(chew) == mark && chew) {
+			++chew;
+		}
+		++tokens;
+	}
+	return tokens;
+}
+
+/// Define `-DBENCH_G<i>=<i>` globals until there are `n` of them.
+void define_globals(size_t n)
+{
+	static size_t defined = 0;
+	for ( ;defined < n; ++defined) {
+		string s = "BENCH_G" + to_string(defined) + '=' + to_string(defined);
+		chewer<string> chew(false,s);
+		symbol::locator sloc(chew);
+		sloc->digest_global_define(chew);
+	}
+}
+
+/// Runs and records the benchmarks selected by `settings`
+struct runner
+{
+	/// Say whether the benchmark called `name` is selected.
+	bool selected(string const & name) const {
+		return name.find(opts.filter) != string::npos;
+	}
+
+	/// Run the benchmark called `name`, if selected, timing `op`.
+	template<typename Op>
+	void operator()(string const & name, Op op) {
+		if (selected(name)) {
+			cerr << name << "...\n";
+			results.push_back(measure(name,op,opts.min_time));
+		}
+	}
+
+	/// The commandline settings
+	settings const & opts;
+	/// The results of the benchmarks run so far
+	vector<result> results;
+};
+
+/// Run the benchmarks selected by `opts`
+vector<result> run(settings const & opts)
+{
+	runner bench{opts,{}};
+
+	/*	Each operation is the end of a file that #defines one symbol.
+		These run first because the cache activity of the other benchmarks
+		advances the symbol snapshot that per_file_init() consults.
+	*/
+	for (size_t globals : {1000,10000,100000}) {
+		string name = "symbol/per_file_init/" + to_string(globals);
+		if (bench.selected(name)) {
+			define_globals(globals);
+			bench(name,[]{
+				symbol::locator local(string("BENCH_LOCAL"));
+				local->digest_transient_define(formal_parameter_list(),"1");
+				symbol::per_file_init();
+			});
+		}
+	}
+
+	string text = c_text();
+	bench("chewer/code",[&]{
+		chewer<string> chew(true,text);
+		chew(code);
+		sink += size_t(chew);
+	});
+	bench("chewer/tokens",[&]{
+		sink += tokenize(true,text);
+	});
+	bench("chewer/plaintext_tokens",[&]{
+		sink += tokenize(false,text);
+	});
+
+	vector<parse_buffer> directives = directive_lines();
+	bench("directive/keywords",[&]{
+		for (auto & line : directives) {
+			chewer<parse_buffer> chew(true,line);
+			size_t len;
+			sink += directive_base::get_type(chew,len);
+		}
+	});
+
+	string buf;
+	auto parse = [&](char const * expr) {
+		buf.assign(expr);
+		chewer<string> chew(true,buf);
+		expression_parser<string> ep(chew);
+		sink += ep.result().resolved();
+	};
+	bench("expression_parser/short",[&]{
+		parse("1 + 2");
+	});
+	bench("expression_parser/long",[&]{
+		parse("defined(BENCH_N) && (BENCH_N * 2 + 0x10) > 64 || "
+			"((3 << 2) % 5 == 2 ? 1 : 0) && BENCH_F(2,3) == 7");
+	});
+
+	string call("BENCH_F(3,4)");
+	auto lookup = [&]{
+		chewer<string> chew(true,call);
+		symbol::locator loc(chew);
+		reference ref(loc,chew);
+		sink += ref.eval().resolved();
+	};
+	bench("reference/lookup_hit",lookup);
+	bench("reference/lookup_miss",[&]{
+		reference_cache::clear();
+		lookup();
+	});
+
+	vector<string> numerals {
+		"1234567", "0x7fffffffUL", "0777", "18446744073709551615ULL" };
+	bench("integer_constant/numerals",[&]{
+		for (auto & numeral : numerals) {
+			chewer<string> chew(true,numeral);
+			sink += integer_constant::read_numeral(chew).good();
+		}
+	});
+	string quoted("'\\n'");
+	bench("integer_constant/char",[&]{
+		chewer<string> chew(true,quoted);
+		sink += integer_constant::read_char(chew).good();
+	});
+
+	name_trie selection;
+	for (size_t i = 0; i < 5000; ++i) {
+		selection.add("BENCH_P" + to_string(i) + (i % 2 ? "_*" : ""));
+	}
+	vector<string> names {
+		"BENCH_P4998", "BENCH_P1235_SUFFIX", "BENCH_P1234_SUFFIX", "BENCH_Q" };
+	bench("name_trie/matches",[&]{
+		for (auto & name : names) {
+			sink += selection.matches(name);
+		}
+	});
+
+	return bench.results;
+}
+
+/// Write `results` as JSON, one benchmark per line.
+void write_json(ostream & out, vector<result> const & results)
+{
+	out << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		result const & r = results[i];
+		out << "    {\"name\": \"" << r.name
+			<< "\", \"iterations\": " << r.iterations
+			<< ", \"ns_per_op\": " << r.ns_per_op
+			<< ", \"allocs_per_op\": " << r.allocs_per_op
+			<< ", \"bytes_per_op\": " << r.bytes_per_op << '}'
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}\n";
+}
+
+/** \brief Get the number that follows `"key": ` in `line`, or -1.
+ *
+ *	Only the layout written by `write_json()` is understood.
+ */
+double json_number(string const & line, char const * key)
+{
+	string tag = string("\"") + key + "\": ";
+	size_t pos = line.find(tag);
+	return pos == string::npos ? -1 : strtod(line.c_str() + pos + tag.size(),
+											nullptr);
+}
+
+/// Read results written by `write_json()` from `filename`
+vector<result> read_json(string const & filename)
+{
+	ifstream in(filename);
+	if (!in) {
+		cerr << "coan_bench: cannot read \"" << filename << "\"\n";
+		exit(2);
+	}
+	vector<result> results;
+	string const tag("{\"name\": \"");
+	for (string line; getline(in,line); ) {
+		size_t pos = line.find(tag);
+		if (pos == string::npos) {
+			continue;
+		}
+		pos += tag.size();
+		result r;
+		r.name = line.substr(pos,line.find('\"',pos) - pos);
+		r.iterations = (unsigned long long)json_number(line,"iterations");
+		r.ns_per_op = json_number(line,"ns_per_op");
+		r.allocs_per_op = json_number(line,"allocs_per_op");
+		r.bytes_per_op = json_number(line,"bytes_per_op");
+		results.push_back(r);
+	}
+	return results;
+}
+
+/** \brief Compare `current` results with `baseline` results.
+ *	\return True iff any benchmark has regressed.
+ */
+bool compare(	vector<result> const & baseline,
+				vector<result> const & current,
+				double threshold)
+{
+	bool regressed = false;
+	printf("%-34s %14s %14s %9s %13s\n",
+		"benchmark","baseline ns","current ns","change","allocs/op");
+	for (result const & cur : current) {
+		result const * base = nullptr;
+		for (result const & r : baseline) {
+			if (r.name == cur.name) {
+				base = &r;
+				break;
+			}
+		}
+		if (!base) {
+			printf("%-34s %14s %14.1f %9s %6s->%-6.2f\n",
+				cur.name.c_str(),"-",cur.ns_per_op,"new","-",
+				cur.allocs_per_op);
+			continue;
+		}
+		double change = base->ns_per_op > 0 ?
+			(cur.ns_per_op - base->ns_per_op) * 100 / base->ns_per_op : 0;
+		bool worse = change > threshold ||
+			cur.allocs_per_op > base->allocs_per_op + 0.5;
+		regressed = regressed || worse;
+		printf("%-34s %14.1f %14.1f %+8.1f%% %6.2f->%-6.2f%s\n",
+			cur.name.c_str(),base->ns_per_op,cur.ns_per_op,change,
+			base->allocs_per_op,cur.allocs_per_op,
+			worse ? " REGRESSED" : "");
+	}
+	return regressed;
+}
+
+/** \brief Put coan in the state that its analysis code expects.
+ *
+ *	Warnings are gagged, so that the benchmarks neither write them nor
+ *	time their composition, e.g. the "has been assumed for the current
+ *	file" warning of each transient `#define`.
+ */
+void init_coan(char * argv0)
+{
+	vector<string> args {
+		argv0, "source", "--gag", "warning",
+		"-DBENCH_N=42", "-DBENCH_F(x,y)=((x)*(y)+1)" };
+	vector<char *> argv;
+	for (auto & arg : args) {
+		argv.push_back(&arg[0]);
+	}
+	argv.push_back(nullptr);
+	options::parse_executable(argv.data());
+	options::parse(int(args.size()),argv.data());
+}
+
+/// Print usage and exit with status 2.
+void usage()
+{
+	cerr << "Usage:\n"
+		"  coan_bench [--filter TEXT] [--min-time SECS] [--out FILE]\n"
+		"  coan_bench compare BASELINE [CURRENT] [--threshold PCT]\n"
+		"             [--filter TEXT] [--min-time SECS]\n";
+	exit(2);
+}
+
+} // namespace
+
+#ifdef __GNUC__
+/** \brief Keep a replacement allocation function out of line, so that
+ *	GCC matches `operator delete` with `operator new` rather than seeing
+ *	the `free()` inside one applied to the result of the other.
+ */
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+/// Count global heap allocations for the benchmarks' `allocs_per_op`.
+OUT_OF_LINE void * operator new(size_t size)
+{
+	++alloc_count;
+	alloc_bytes += size;
+	void * p = malloc(size ? size : 1);
+	if (!p) {
+		throw bad_alloc();
+	}
+	return p;
+}
+
+/// Counterpart of the counting `operator new`
+OUT_OF_LINE void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+/// Counterpart of the counting `operator new`
+OUT_OF_LINE void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+/// Counterpart of the counting `operator new`
+OUT_OF_LINE void operator delete[](void * p) noexcept
+{
+	operator delete(p);
+}
+
+/// Counterpart of the counting `operator new`
+OUT_OF_LINE void operator delete(void * p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+/// Counterpart of the counting `operator new`
+OUT_OF_LINE void operator delete[](void * p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+/// coan_bench main entry point
+int main(int argc, char *argv[])
+{
+	settings opts;
+	vector<string> files;
+	bool comparing = argc > 1 && strcmp(argv[1],"compare") == 0;
+	for (int i = comparing ? 2 : 1; i < argc; ++i) {
+		string arg(argv[i]);
+		bool more = i + 1 < argc;
+		if (arg == "--filter" && more) {
+			opts.filter = argv[++i];
+		} else if (arg == "--min-time" && more) {
+			opts.min_time = atof(argv[++i]);
+		} else if (arg == "--out" && more && !comparing) {
+			opts.out = argv[++i];
+		} else if (arg == "--threshold" && more && comparing) {
+			opts.threshold = atof(argv[++i]);
+		} else if (comparing && arg[0] != '-' && files.size() < 2) {
+			files.push_back(arg);
+		} else {
+			usage();
+		}
+	}
+	if (comparing) {
+		if (files.empty()) {
+			usage();
+		}
+		vector<result> baseline = read_json(files[0]);
+		vector<result> current;
+		if (files.size() > 1) {
+			current = read_json(files[1]);
+		} else {
+			init_coan(argv[0]);
+			current = run(opts);
+		}
+		return compare(baseline,current,opts.threshold) ? 1 : 0;
+	}
+	init_coan(argv[0]);
+	vector<result> results = run(opts);
+	if (opts.out.empty()) {
+		write_json(cout,results);
+	} else {
+		ofstream out(opts.out);
+		write_json(out,results);
+		if (!out) {
+			cerr << "coan_bench: cannot write \"" << opts.out << "\"\n";
+			return 2;
+		}
+	}
+	return 0;
+}
+
+/* EOF*/
@@ -0,0 +1,434 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "compile_db.h"
+#include "options.h"
+#include "filesys.h"
+#include "path.h"
+#include "diagnostic.h"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstring>
+
+/** \file compile_db.cpp
+ *   This file implements `struct compile_db`
+ */
+
+using namespace std;
+
+string compile_db::_filename_;
+vector<compile_db::config> compile_db::_configs_;
+map<string,size_t> compile_db::_config_index_;
+map<string,size_t> compile_db::_files_;
+size_t compile_db::_selected_ = size_t(-1);
+
+namespace {
+
+/** \brief `struct json_reader` reads the entries of a compilation
+ *	database.
+ *
+ *	Only the members `directory`, `file`, `arguments` and `command` of
+ *	each entry are kept. Other values are read and discarded.
+ */
+struct json_reader {
+
+	/// `struct entry` holds an entry of the compilation database.
+	struct entry {
+		/// The working directory of the compilation.
+		std::string _directory;
+		/// The source file, maybe relative to `_directory`.
+		std::string _file;
+		/// The compiler arguments.
+		std::vector<std::string> _arguments;
+	};
+
+	/** \brief Explicitly construct given the text of the database.
+	 *	\param dbname The name of the database.
+	 *	\param text The contents of the database.
+	 */
+	json_reader(string const & dbname, string const & text)
+	: _dbname(dbname),_text(text){}
+
+	/// Read the array of entries.
+	vector<entry> entries() {
+		vector<entry> result;
+		expect('[');
+		if (!accept(']')) {
+			do {
+				result.push_back(read_entry());
+			} while (accept(','));
+			expect(']');
+		}
+		skip_space();
+		if (_pos != _text.length()) {
+			invalid("garbage after entries");
+		}
+		return result;
+	}
+
+private:
+
+	/// Read an object that is an entry.
+	entry read_entry() {
+		entry e;
+		string command;
+		expect('{');
+		if (!accept('}')) {
+			do {
+				string key = read_string();
+				expect(':');
+				if (key == "directory") {
+					e._directory = read_string();
+				} else if (key == "file") {
+					e._file = read_string();
+				} else if (key == "command") {
+					command = read_string();
+				} else if (key == "arguments") {
+					expect('[');
+					if (!accept(']')) {
+						do {
+							e._arguments.push_back(read_string());
+						} while (accept(','));
+						expect(']');
+					}
+				} else {
+					skip_value();
+				}
+			} while (accept(','));
+			expect('}');
+		}
+		if (e._file.empty()) {
+			invalid("entry without \"file\"");
+		}
+		if (e._arguments.empty()) {
+			split(command,e._arguments);
+		}
+		return e;
+	}
+
+	/// Read a string, translating its escapes.
+	string read_string() {
+		string s;
+		expect('"');
+		for (char c; (c = next()) != '"'; ) {
+			if (c != '\\') {
+				s += c;
+				continue;
+			}
+			c = next();
+			switch(c) {
+			case 'b':
+				s += '\b';
+				break;
+			case 'f':
+				s += '\f';
+				break;
+			case 'n':
+				s += '\n';
+				break;
+			case 'r':
+				s += '\r';
+				break;
+			case 't':
+				s += '\t';
+				break;
+			case 'u': {
+				unsigned code = 0;
+				for (int i = 0; i < 4; ++i) {
+					c = next();
+					if (!isxdigit(c)) {
+						invalid("bad \\u escape");
+					}
+					code = code * 16 +
+						(isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+				}
+				/* Encode as UTF-8. Surrogates are kept as they come */
+				if (code < 0x80) {
+					s += char(code);
+				} else if (code < 0x800) {
+					s += char(0xc0 | (code >> 6));
+					s += char(0x80 | (code & 0x3f));
+				} else {
+					s += char(0xe0 | (code >> 12));
+					s += char(0x80 | ((code >> 6) & 0x3f));
+					s += char(0x80 | (code & 0x3f));
+				}
+			}
+			break;
+			default:
+				s += c;
+			}
+		}
+		return s;
+	}
+
+	/// Read and discard a value of any type.
+	void skip_value() {
+		skip_space();
+		char c = peek();
+		if (c == '"') {
+			read_string();
+		} else if (accept('[')) {
+			if (!accept(']')) {
+				do {
+					skip_value();
+				} while (accept(','));
+				expect(']');
+			}
+		} else if (accept('{')) {
+			if (!accept('}')) {
+				do {
+					read_string();
+					expect(':');
+					skip_value();
+				} while (accept(','));
+				expect('}');
+			}
+		} else {
+			size_t start = _pos;
+			for (	; _pos < _text.length() &&
+					(isalnum(_text[_pos]) || strchr("+-.",_text[_pos]));
+					++_pos) {}
+			if (_pos == start) {
+				invalid("value expected");
+			}
+		}
+	}
+
+	/** \brief Split a command into arguments as a POSIX shell would.
+	 *	\param command The command.
+	 *	\param args On return, the arguments of `command`.
+	 */
+	static void split(string const & command, vector<string> & args) {
+		string arg;
+		bool in_arg = false;
+		char quote = 0;
+		for (size_t i = 0; i < command.length(); ++i) {
+			char c = command[i];
+			if (quote) {
+				if (c == quote) {
+					quote = 0;
+				} else if (c == '\\' && quote == '"' &&
+						i + 1 < command.length() &&
+						strchr("\"\\$`",command[i + 1])) {
+					arg += command[++i];
+				} else {
+					arg += c;
+				}
+			} else if (isspace(c)) {
+				if (in_arg) {
+					args.push_back(arg);
+					arg.clear();
+					in_arg = false;
+				}
+			} else {
+				in_arg = true;
+				if (c == '"' || c == '\'') {
+					quote = c;
+				} else if (c == '\\' && i + 1 < command.length()) {
+					arg += command[++i];
+				} else {
+					arg += c;
+				}
+			}
+		}
+		if (in_arg) {
+			args.push_back(arg);
+		}
+	}
+
+	/// Skip whitespace.
+	void skip_space() {
+		for (	; _pos < _text.length() && isspace(_text[_pos]); ++_pos) {}
+	}
+
+	/// Get the next character, or '\0' at the end of the text.
+	char peek() const {
+		return _pos < _text.length() ? _text[_pos] : '\0';
+	}
+
+	/// Consume the next character, which must exist.
+	char next() {
+		if (_pos == _text.length()) {
+			invalid("unexpected end of text");
+		}
+		return _text[_pos++];
+	}
+
+	/// Consume a punctuator if it is next after whitespace.
+	bool accept(char punct) {
+		skip_space();
+		if (peek() == punct) {
+			++_pos;
+			return true;
+		}
+		return false;
+	}
+
+	/// Consume a punctuator that must be next after whitespace.
+	void expect(char punct) {
+		if (!accept(punct)) {
+			invalid(string("'") + punct + "' expected");
+		}
+	}
+
+	/// Report that the database is invalid.
+	void invalid(string const & why) const {
+		abend_invalid_compile_db() << "Invalid compilation database \"" <<
+			_dbname << "\": " << why << " at offset " << _pos << emit();
+	}
+
+	/// The name of the database.
+	string const & _dbname;
+	/// The contents of the database.
+	string const & _text;
+	/// The offset of the next character to be read.
+	size_t _pos = 0;
+};
+
+} // namespace
+
+vector<string> compile_db::load()
+{
+	vector<string> files;
+	ifstream in(_filename_.c_str(),ios::binary);
+	if (!in.good()) {
+		abend_cant_open_input() << "Can't open " <<
+			_filename_ << " for reading" << emit();
+	}
+	ostringstream text;
+	text << in.rdbuf();
+	string const contents = text.str();
+	json_reader reader(_filename_,contents);
+	for (json_reader::entry const & e : reader.entries()) {
+		string filename = e._file;
+		if (!fs::is_absolute(filename)) {
+			path_t dir(fs::abs_path(e._directory));
+			dir.push_back(filename);
+			filename = dir.str();
+		}
+		fs::obj_type_t type = fs::obj_type(filename);
+		if (!fs::is_file(type)) {
+			warning_missing_db_file() << "File \"" << filename <<
+				"\" in compilation database is not found. Ignored" << emit();
+			continue;
+		}
+		filename = fs::real_path(filename);
+		if (!_files_.count(filename)) {
+			files.push_back(filename);
+		}
+		add(filename,e._arguments);
+	}
+	progress_building_tree() << files.size() << " files in " <<
+		_configs_.size() << " configurations from \"" << _filename_ <<
+		'\"' << emit();
+	return files;
+}
+
+void compile_db::add(string const & filename, vector<string> const & args)
+{
+	map<string,string> folded;
+	vector<string> config_args;
+	string key;
+	for (size_t i = 0; i < args.size(); ++i) {
+		string const & arg = args[i];
+		if (arg.length() < 2 || arg[0] != '-' ||
+				(arg[1] != 'D' && arg[1] != 'U')) {
+			continue;
+		}
+		string sym = arg.substr(2);
+		if (sym.empty()) {
+			if (++i == args.size()) {
+				break;
+			}
+			sym = args[i];
+		}
+		if (arg[1] == 'D' && sym.find('=') == string::npos) {
+			/* Like the compiler, take -DSYM as -DSYM=1 */
+			sym += "=1";
+		}
+		string opt = string("-") + arg[1] + sym;
+		/* As with the compiler, the last option for a symbol wins */
+		folded[options::config_arg_id(opt)] = opt;
+	}
+	for (auto const & entry : folded) {
+		config_args.push_back(entry.second);
+		key += entry.second + '\n';
+	}
+	auto found = _config_index_.find(key);
+	auto prior = _files_.find(filename);
+	if (prior != _files_.end()) {
+		if (found == _config_index_.end() || found->second != prior->second) {
+			warning_multiply_configured() << "File \"" << filename <<
+				"\" has several configurations in the compilation database. "
+				"The first is used" << emit();
+		}
+		return;
+	}
+	if (found == _config_index_.end()) {
+		found = _config_index_.insert(make_pair(key,_configs_.size())).first;
+		_configs_.push_back(config());
+		_configs_.back()._args.swap(config_args);
+	}
+	_files_[filename] = found->second;
+}
+
+void compile_db::configure()
+{
+	for (config & c : _configs_) {
+		symbol::swap(c._symbols);
+		options::parse_config_args(c._args);
+		symbol::swap(c._symbols);
+	}
+}
+
+bool compile_db::select(string const & filename)
+{
+	auto found = _files_.find(filename);
+	if (found == _files_.end()) {
+		return false;
+	}
+	_selected_ = found->second;
+	symbol::swap(_configs_[_selected_]._symbols);
+	return true;
+}
+
+void compile_db::deselect()
+{
+	symbol::per_file_init();
+	symbol::swap(_configs_[_selected_]._symbols);
+	_selected_ = size_t(-1);
+}
+
+// EOF
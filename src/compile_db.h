@@ -0,0 +1,130 @@
+#ifndef COMPILE_DB_H
+#define COMPILE_DB_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "symbol.h"
+#include <string>
+#include <vector>
+#include <map>
+
+/** \file compile_db.h
+ *   This file defines `struct compile_db`
+ */
+
+/** \brief `struct compile_db` configures input files from a compilation
+ *	database.
+ *
+ *  With the `--compile-db FILE` option, the source files of the entries
+ *	in the compilation database `FILE` (in the JSON format of
+ *	`compile_commands.json`) are added to the input files, and each of them
+ *	is processed under the `--define` and `--undef` options of the
+ *	commandline followed by the `-D` and `-U` options of its compiler
+ *	arguments. The last of these options for a symbol wins, and overrides
+ *	any option for the symbol on the commandline.
+ *
+ *  Files whose entries have the same `-D` and `-U` options share one
+ *	configuration, with its own symbol table and reference cache, that is
+ *	digested once and made operative for each of the files in turn.
+ */
+struct compile_db {
+
+	/** \brief Specify the compilation database.
+	 *	\param filename The argument of the `--compile-db` option.
+	 */
+	static void set(std::string const & filename) {
+		_filename_ = filename;
+	}
+
+	/// Say whether a compilation database is given.
+	static bool on() {
+		return !_filename_.empty();
+	}
+
+	/** \brief Read the compilation database.
+	 *	\return The existing source files of its entries.
+	 */
+	static std::vector<std::string> load();
+
+	/// Digest the configurations of the compilation database.
+	static void configure();
+
+	/// Get the number of distinct configurations.
+	static size_t count() {
+		return _configs_.size();
+	}
+
+	/** \brief Make the configuration of a file operative, if it has one.
+	 *	\param filename The absolute name of an input file.
+	 *	\return True if a configuration was made operative.
+	 */
+	static bool select(std::string const & filename);
+
+	/** \brief Make the configuration of the commandline operative again.
+	 *
+	 *	The transient symbols of the current file are first deleted from
+	 *	the operative configuration.
+	 */
+	static void deselect();
+
+private:
+
+	/// `struct config` is a configuration shared by files.
+	struct config {
+		/// The `-D` and `-U` options of the configuration.
+		std::vector<std::string> _args;
+		/// The configuration of symbols, while not operative.
+		symbol::configuration _symbols;
+	};
+
+	/** \brief Add an entry of the compilation database.
+	 *	\param filename The absolute real name of the source file.
+	 *	\param args The compiler arguments of the entry.
+	 */
+	static void add(std::string const & filename,
+		std::vector<std::string> const & args);
+
+	/// The name of the compilation database.
+	static std::string _filename_;
+	/// The configurations.
+	static std::vector<config> _configs_;
+	/// Map from the options of each configuration to its index.
+	static std::map<std::string,size_t> _config_index_;
+	/// Map from each file to the index of its configuration.
+	static std::map<std::string,size_t> _files_;
+	/// The index of the operative configuration, if any.
+	static size_t _selected_;
+};
+
+#endif // EOF
@@ -0,0 +1,363 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "config_header.h"
+#include "symbol.h"
+#include "canonical.h"
+#include "filesys.h"
+#include "diagnostic.h"
+#include <algorithm>
+#include <cctype>
+
+/** \file config_header.cpp
+ *   This file implements `struct config_header`
+ */
+
+using namespace std;
+
+namespace {
+
+/** \brief `struct scanner` extracts the directives from the mapped
+ *	contents of a configuration header.
+ *
+ *	Comments are replaced with a space and line-continuations are
+ *	removed. The text of lines that are not directives is scanned only
+ *	for comments and literals, and is not kept.
+ */
+struct scanner {
+
+	/** \brief Construct given the contents of the header.
+	 *	\param data The contents of the header.
+	 *	\param size The size of the contents.
+	 */
+	scanner(char const * data, size_t size)
+	: _data(data),_pos(data),_end(data + size),_start(data){}
+
+	/** \brief Scan to the next directive.
+	 *	\param directive On return, the text of the directive following
+	 *		the `#`.
+	 *	\return True if a directive was scanned, false at the end of the
+	 *		contents.
+	 */
+	bool next(string & directive) {
+		while (_pos < _end) {
+			skip_space();
+			bool is_directive = _pos < _end && *_pos == '#';
+			if (is_directive) {
+				_start = _pos++;
+				directive.clear();
+			}
+			rest_of_line(is_directive ? &directive : nullptr);
+			if (is_directive) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Get the line number of the latest directive.
+	size_t line() const {
+		return count(_data,_start,'\n') + 1;
+	}
+
+private:
+
+	/// Say whether a line-continuation is next and if so consume it.
+	bool continuation() {
+		if (_pos[0] != '\\') {
+			return false;
+		}
+		if (_pos + 1 < _end && _pos[1] == '\n') {
+			_pos += 2;
+			return true;
+		}
+		if (_pos + 2 < _end && _pos[1] == '\r' && _pos[2] == '\n') {
+			_pos += 3;
+			return true;
+		}
+		return false;
+	}
+
+	/// Say whether a comment of the given kind is next.
+	bool comment_next(char kind) const {
+		return _pos[0] == '/' && _pos + 1 < _end && _pos[1] == kind;
+	}
+
+	/// Consume a block comment.
+	void skip_block_comment() {
+		_pos += 2;
+		for ( ; _pos + 1 < _end; ++_pos) {
+			if (_pos[0] == '*' && _pos[1] == '/') {
+				_pos += 2;
+				return;
+			}
+		}
+		_pos = _end;
+	}
+
+	/// Consume horizontal whitespace, continuations and block comments.
+	void skip_space() {
+		while (_pos < _end) {
+			if (*_pos == ' ' || *_pos == '\t' || *_pos == '\f' ||
+					*_pos == '\v' || *_pos == '\r') {
+				++_pos;
+			} else if (comment_next('*')) {
+				skip_block_comment();
+			} else if (!continuation()) {
+				break;
+			}
+		}
+	}
+
+	/** \brief Consume a character or string literal.
+	 *	\param text If not null, receives the literal.
+	 */
+	void literal(string * text) {
+		char quote = *_pos;
+		if (text) {
+			*text += quote;
+		}
+		for (++_pos; _pos < _end; ) {
+			if (continuation()) {
+				continue;
+			}
+			char c = *_pos;
+			if (c == '\n') {
+				return;
+			}
+			if (text) {
+				*text += c;
+			}
+			++_pos;
+			if (c == quote) {
+				return;
+			}
+			if (c == '\\' && _pos < _end && *_pos != '\n') {
+				if (text) {
+					*text += *_pos;
+				}
+				++_pos;
+			}
+		}
+	}
+
+	/** \brief Consume the rest of a logical line and its newline.
+	 *	\param text If not null, receives the rest of the line.
+	 */
+	void rest_of_line(string * text) {
+		while (_pos < _end) {
+			char c = *_pos;
+			if (c == '\n') {
+				++_pos;
+				return;
+			}
+			if (continuation()) {
+				continue;
+			}
+			if (comment_next('*')) {
+				skip_block_comment();
+				if (text) {
+					*text += ' ';
+				}
+			} else if (comment_next('/')) {
+				while (_pos < _end && *_pos != '\n') {
+					if (!continuation()) {
+						++_pos;
+					}
+				}
+			} else if (c == '"' || c == '\'') {
+				literal(text);
+			} else {
+				if (text && c != '\r') {
+					*text += c;
+				}
+				++_pos;
+			}
+		}
+	}
+
+	/// The start of the contents.
+	char const * _data;
+	/// The scanning position.
+	char const * _pos;
+	/// The end of the contents.
+	char const * _end;
+	/// The start of the latest directive.
+	char const * _start;
+};
+
+/// Say whether a character is whitespace within a directive.
+bool is_space(char c)
+{
+	return isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+/// Say whether a character can occur in an identifier.
+bool is_ident(char c)
+{
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/** \brief Read an identifier from a directive.
+ *	\param text The directive.
+ *	\param off On entry, the offset at which to read. On return, the offset
+ *		past the identifier.
+ *	\return The identifier, empty if none is at `off`.
+ */
+string read_ident(string const & text, size_t & off)
+{
+	size_t start = off;
+	if (off < text.size() &&
+			!isdigit(static_cast<unsigned char>(text[off]))) {
+		while (off < text.size() && is_ident(text[off])) {
+			++off;
+		}
+	}
+	return text.substr(start,off - start);
+}
+
+/// Advance an offset in a directive past whitespace.
+void skip_space(string const & text, size_t & off)
+{
+	while (off < text.size() && is_space(text[off])) {
+		++off;
+	}
+}
+
+/// Get the remainder of a directive from an offset, without trailing space.
+string remainder(string const & text, size_t off)
+{
+	size_t end = text.size();
+	while (end > off && is_space(text[end - 1])) {
+		--end;
+	}
+	return text.substr(off,end - off);
+}
+
+/// The parts of a `#define` or `#undef` directive in a header.
+struct entry {
+	/// Is the directive a `#define`?
+	bool define;
+	/// The name of the symbol.
+	string id;
+	/// The text of the parameter list, if any.
+	string params;
+	/// The text of the definition, if any.
+	string defn;
+};
+
+} // namespace
+
+vector<string> config_header::load(string const & filename)
+{
+	vector<string> args;
+	vector<entry> entries;
+	vector<string> names;
+	size_t size = 0;
+	char const * data = fs::map_file(filename,size);
+	if (!data) {
+		if (fs::is_file(fs::obj_type(filename))) {
+			return args;
+		}
+		abend_cant_open_input() << "Can't open " <<
+			filename << " for reading" << emit();
+	}
+	scanner scan(data,size);
+	string directive;
+	while (scan.next(directive)) {
+		size_t off = 0;
+		skip_space(directive,off);
+		string keyword = read_ident(directive,off);
+		bool define = keyword == "define";
+		if (!define && keyword != "undef") {
+			continue;
+		}
+		skip_space(directive,off);
+		string id = read_ident(directive,off);
+		if (id.empty() || (off < directive.size() && !is_space(directive[off]) &&
+				(!define || directive[off] != '('))) {
+			error_garbage_arg() << "Garbage in \"#" << remainder(directive,0)
+				<< "\" at line " << scan.line() << " of \"" << filename
+				<< '\"' << emit();
+			continue;
+		}
+		entry ent{define,id,string(),string()};
+		if (define && off < directive.size() && directive[off] == '(') {
+			size_t close = directive.find(')',off);
+			close = close == string::npos ? directive.size() : close + 1;
+			ent.params = directive.substr(off,close - off);
+			off = close;
+		}
+		skip_space(directive,off);
+		ent.defn = remainder(directive,off);
+		if (!define && !ent.defn.empty()) {
+			error_garbage_arg() << "Garbage in \"#" << remainder(directive,0)
+				<< "\" at line " << scan.line() << " of \"" << filename
+				<< '\"' << emit();
+			continue;
+		}
+		names.push_back(id);
+		entries.push_back(move(ent));
+	}
+	fs::unmap_file(data,size);
+	sort(names.begin(),names.end());
+	names.erase(unique(names.begin(),names.end()),names.end());
+	symbol::enter(names);
+	for (entry & ent : entries) {
+		symbol::locator sloc(ent.id);
+		if (!ent.define) {
+			sloc->digest_global_undef();
+			args.push_back("-U" + ent.id);
+			continue;
+		}
+		chewer<string> param_chew(false,ent.params);
+		formal_parameter_list params(param_chew);
+		if (!params.well_formed() || param_chew) {
+			error_malformed_macro() <<
+				"Malformed macro parameter list for symbol \""
+				<< ent.id << "\"" << emit();
+			continue;
+		}
+		chewer<string> defn_chew(false,ent.defn);
+		string definition = canonical<string>(defn_chew);
+		sloc->digest_global_define(params,definition);
+		args.push_back("-D" + ent.id + ent.params);
+		if (!definition.empty()) {
+			args.back() += '=';
+			args.back() += definition;
+		}
+	}
+	return args;
+}
+
+// EOF
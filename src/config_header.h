@@ -0,0 +1,71 @@
+#ifndef CONFIG_HEADER_H
+#define CONFIG_HEADER_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+
+/** \file config_header.h
+ *   This file defines `struct config_header`
+ */
+
+/** \brief `struct config_header` reads the global configuration from
+ *	the `#define` and `#undef` directives of a header file.
+ *
+ *  With the `--config-header FILE` option, each `#define` directive in
+ *	`FILE` is digested as the equivalent `--define` option and each `#undef`
+ *	directive as the equivalent `--undef` option, in order of occurrence.
+ *	Comments and line-continuations are observed. Other directives and
+ *	other lines are ignored: conditional directives are not evaluated.
+ *
+ *	The header is scanned from its mapped contents and the names of all
+ *	the symbols it configures are entered in the symbol table in one
+ *	ordered pass before any of them is digested.
+ */
+struct config_header {
+
+	/** \brief Read a configuration header and digest its directives.
+	 *	\param filename The argument of the `--config-header` option.
+	 *	\return The `-D` and `-U` options that are equivalent to the
+	 *	digested directives, in order of occurrence, to be recorded
+	 *	with the configuration arguments.
+	 *
+	 *	The parts of each directive are digested as they were scanned,
+	 *	without being re-parsed as an option.
+	 */
+	static std::vector<std::string> load(std::string const & filename);
+};
+
+#endif // EOF
@@ -0,0 +1,346 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "config_snapshot.h"
+#include "symbol.h"
+#include "options.h"
+#include "filesys.h"
+#include "version.h"
+#include "diagnostic.h"
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+/** \file config_snapshot.cpp
+ *   This file implements `struct config_snapshot`
+ */
+
+using namespace std;
+using parameter_substitution::format;
+
+string config_snapshot::_output_;
+
+/// The first bytes of a precompiled configuration.
+static char const snapshot_magic[8] = "coancfg";
+/// A word written in native byte order, to reject foreign files.
+static uint32_t const byte_order_mark = 0x01020304;
+/// The layout version of precompiled configurations.
+static uint32_t const layout_version = 1;
+
+namespace {
+
+/// `struct writer` writes the fields of a precompiled configuration.
+struct writer {
+
+	/// Explicitly construct given the output stream.
+	explicit writer(ofstream & out)
+	: _out(out){}
+
+	/// Write an unsigned word.
+	void u32(uint32_t w) {
+		_out.write(reinterpret_cast<char const *>(&w),sizeof(w));
+	}
+
+	/// Write a signed word.
+	void i32(int32_t w) {
+		_out.write(reinterpret_cast<char const *>(&w),sizeof(w));
+	}
+
+	/// Write a flag.
+	void flag(bool b) {
+		_out.put(char(b));
+	}
+
+	/// Write a string, preceded by its length.
+	void str(string const & s) {
+		u32(uint32_t(s.size()));
+		_out.write(s.data(),s.size());
+	}
+
+private:
+
+	/// The output stream.
+	ofstream & _out;
+};
+
+/** \brief `struct reader` reads the fields of a precompiled configuration
+ *	from its mapped contents.
+ *
+ *	A read that would overrun the contents is diagnosed as corruption.
+ */
+struct reader {
+
+	/** \brief Construct given the file and its mapped contents.
+	 *	\param filename The name of the file.
+	 *	\param data The contents of the file.
+	 *	\param size The size of the contents.
+	 */
+	reader(string const & filename, char const * data, size_t size)
+	: _filename(filename),_pos(data),_end(data + size){}
+
+	/// Read an unsigned word.
+	uint32_t u32() {
+		uint32_t w;
+		memcpy(&w,take(sizeof(w)),sizeof(w));
+		return w;
+	}
+
+	/// Read a signed word.
+	int32_t i32() {
+		int32_t w;
+		memcpy(&w,take(sizeof(w)),sizeof(w));
+		return w;
+	}
+
+	/// Read a flag.
+	bool flag() {
+		char b = *take(1);
+		if (b != 0 && b != 1) {
+			corrupt();
+		}
+		return b;
+	}
+
+	/// Read a string preceded by its length.
+	string str() {
+		size_t len = u32();
+		return string(take(len),len);
+	}
+
+	/// Read an index less than `n`.
+	size_t ordinal(size_t n) {
+		size_t i = u32();
+		if (i >= n) {
+			corrupt();
+		}
+		return i;
+	}
+
+	/// Say whether all the contents have been read.
+	bool done() const {
+		return _pos == _end;
+	}
+
+	/// Consume `len` bytes and get a pointer to them.
+	char const * take(size_t len) {
+		if (size_t(_end - _pos) < len) {
+			corrupt();
+		}
+		char const * p = _pos;
+		_pos += len;
+		return p;
+	}
+
+	/// Diagnose the file as corrupt.
+	void corrupt() const {
+		abend_invalid_config_snapshot() << '\"' << _filename
+			<< "\" is not a valid precompiled configuration" << emit();
+	}
+
+private:
+
+	/// The name of the file.
+	string const & _filename;
+	/// The read position in the contents.
+	char const * _pos;
+	/// The end of the contents.
+	char const * _end;
+};
+
+} // namespace
+
+void config_snapshot::set_output(string const & filename)
+{
+	if (!_output_.empty()) {
+		error_usage() << "The \"precompile-config\" command takes only "
+			"one output file" << emit();
+	}
+	_output_ = filename;
+}
+
+void config_snapshot::save()
+{
+	/* Subscribe the global symbols, as for the first input file */
+	symbol::per_file_init();
+	ofstream out(_output_.c_str(),ios::binary);
+	if (!out.good()) {
+		abend_cant_open_output() << "Can't open " <<
+			_output_ << " for writing" << emit();
+	}
+	writer put(out);
+	out.write(snapshot_magic,sizeof(snapshot_magic));
+	put.u32(byte_order_mark);
+	put.u32(layout_version);
+	put.str(version_number());
+	put.i32(symbol::_current_snapshot_);
+	put.i32(symbol::_last_global_snapshot_);
+	vector<string> const & args = options::config_args();
+	put.u32(uint32_t(args.size()));
+	for (string const & arg : args) {
+		put.str(arg);
+	}
+	auto const first = ++symbol::table().begin();
+	auto const last = symbol::table().end();
+	map<symbol const *,uint32_t> ordinals;
+	put.u32(uint32_t(symbol::count()));
+	for (auto i = first; i != last; ++i) {
+		symbol const & sym = i->second;
+		ordinals.emplace(&sym,uint32_t(ordinals.size()));
+		put.str(i->first);
+		put.u32(uint32_t(sym._provenance));
+		put.flag(sym._invoked);
+		put.i32(sym._snapshot);
+		put.u32(sym._line);
+		put.flag(bool(sym._defn));
+		if (sym._defn) {
+			put.str(*sym._defn);
+		}
+		/* Imputed parameters are recorded by number, others as text */
+		string params = sym._params.str();
+		bool imputed =
+			params == formal_parameter_list(sym._params.size()).str();
+		put.flag(imputed);
+		if (imputed) {
+			put.u32(uint32_t(sym._params.size()));
+		} else {
+			put.str(params);
+		}
+		put.flag(bool(sym._format));
+		if (sym._format) {
+			put.str(sym._format->_fmt);
+		}
+	}
+	for (auto i = first; i != last; ++i) {
+		symbol const & sym = i->second;
+		put.u32(uint32_t(sym._contributors.size()));
+		for (symbol::locator const & loc : sym._contributors) {
+			put.u32(ordinals[&*loc]);
+		}
+		put.u32(uint32_t(sym._subscribers.size()));
+		for (symbol::locator const & loc : sym._subscribers) {
+			put.u32(ordinals[&*loc]);
+		}
+	}
+	out.close();
+	if (!out.good()) {
+		abend_cant_write_file() << "Can't write " << _output_ << emit();
+	}
+}
+
+vector<string> config_snapshot::load(string const & filename)
+{
+	size_t size = 0;
+	char const * data = fs::map_file(filename,size);
+	if (!data) {
+		abend_cant_open_input() << "Can't open " <<
+			filename << " for reading" << emit();
+	}
+	reader get(filename,data,size);
+	if (memcmp(get.take(sizeof(snapshot_magic)),snapshot_magic,
+			sizeof(snapshot_magic)) ||
+			get.u32() != byte_order_mark || get.u32() != layout_version) {
+		get.corrupt();
+	}
+	string version = get.str();
+	if (version != version_number()) {
+		abend_invalid_config_snapshot() << '\"' << filename
+			<< "\" was precompiled by coan " << version << ", not "
+			<< version_number() << emit();
+	}
+	int current_snapshot = get.i32();
+	int last_global_snapshot = get.i32();
+	vector<string> args;
+	for (size_t n = get.u32(); n; --n) {
+		args.push_back(get.str());
+	}
+	size_t count = get.u32();
+	vector<symbol::symbol_table::iterator> syms;
+	for (size_t n = 0; n < count; ++n) {
+		string id = get.str();
+		uint32_t origin = get.u32();
+		if (origin != uint32_t(symbol::provenance::unconfigured) &&
+				origin != uint32_t(symbol::provenance::global)) {
+			get.corrupt();
+		}
+		auto where = symbol::insert(id,symbol::provenance(origin));
+		if (symbol::count() != n + 1) {
+			/* Duplicate name */
+			get.corrupt();
+		}
+		symbol & sym = where->second;
+		sym._invoked = get.flag();
+		sym._snapshot = get.i32();
+		sym._line = get.u32();
+		if (get.flag()) {
+			sym._defn = make_shared<string>(get.str());
+		}
+		if (get.flag()) {
+			sym._params = formal_parameter_list(get.u32());
+		} else {
+			string params = get.str();
+			chewer<string> chew(chew_mode::plaintext,params);
+			sym._params = formal_parameter_list(chew);
+			if (sym._params.str() != params) {
+				get.corrupt();
+			}
+		}
+		if (get.flag()) {
+			shared_ptr<format> fmt(new format);
+			fmt->_fmt = get.str();
+			fmt->tokenize();
+			sym._format = fmt;
+		}
+		syms.push_back(where);
+	}
+	for (auto where : syms) {
+		symbol & sym = where->second;
+		sym._contributors.resize(get.ordinal(count + 1));
+		for (symbol::locator & loc : sym._contributors) {
+			loc = symbol::locator(syms[get.ordinal(count)]);
+		}
+		sym._subscribers.resize(get.ordinal(count + 1));
+		for (symbol::locator & loc : sym._subscribers) {
+			loc = symbol::locator(syms[get.ordinal(count)]);
+		}
+	}
+	if (!get.done()) {
+		get.corrupt();
+	}
+	fs::unmap_file(data,size);
+	symbol::_current_snapshot_ = current_snapshot;
+	symbol::_last_global_snapshot_ = last_global_snapshot;
+	symbol::_presubscribed_ = true;
+	return args;
+}
+
+// EOF
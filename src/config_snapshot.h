@@ -0,0 +1,86 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+
+/** \file config_snapshot.h
+ *   This file defines `struct config_snapshot`
+ */
+
+/** \brief `struct config_snapshot` saves the digested global configuration
+ *	of symbols to a file and restores it.
+ *
+ *  The `precompile-config` command digests the `--define` and `--undef`
+ *	options it is given, as any processing command would before reading
+ *	its first input file, and writes the resulting symbol table to a
+ *	binary file. The `--config FILE` option of a later command restores
+ *	the symbol table from `FILE` instead of parsing and digesting the
+ *	options again.
+ *
+ *	The file records the version of coan that wrote it and is rejected
+ *	by any other version.
+ */
+struct config_snapshot {
+
+	/** \brief Specify the file to be written by `precompile-config`.
+	 *	\param filename The file argument of the command.
+	 */
+	static void set_output(std::string const & filename);
+
+	/// Get the file to be written by `precompile-config`, if any.
+	static std::string const & output() {
+		return _output_;
+	}
+
+	/// Write the global configuration to the output file.
+	static void save();
+
+	/** \brief Restore the global configuration from a file.
+	 *	\param filename The argument of the `--config` option.
+	 *	\return The `--define` and `--undef` options recorded in the file.
+	 *
+	 *	The symbol table must be empty.
+	 */
+	static std::vector<std::string> load(std::string const & filename);
+
+private:
+
+	/// The file to be written by `precompile-config`.
+	static std::string _output_;
+};
+
+#endif // EOF
@@ -77,6 +77,11 @@ struct contradiction
 		_policy_ = p;
 	}
 
+	/// Get the operative contradiction policy.
+	static contradiction_policy get_contradiction_policy() {
+		return _policy_;
+	}
+
 	/*! \brief Forget about an apparent contradiction.
      *
      *  The function causes the program to forget about a contradiction
@@ -157,6 +162,11 @@ struct contradiction
 	 */
 	static void save(cause why, std::string const & symname);
 
+	/// Say whether a contradiction is pending discharge or forgetting.
+	static bool pending() {
+		return _policy_code_ != 0;
+	}
+
 	/** \brief Get the name of the latest `#undef`-ed symbol.
      *
 	 *   Return the symbol name that was undefined by the last
@@ -169,6 +179,15 @@ struct contradiction
 		return _last_conflicted_symbol_;
 	}
 
+	/** \brief Exchange the name of the latest `#undef`-ed symbol with
+	 *	another one.
+	 *
+	 *	\param id The symbol name to exchange.
+	 */
+	static void swap_last_conflicted_symbol_id(std::string & id) {
+		_last_conflicted_symbol_.swap(id);
+	}
+
 private:
 
 	/** \brief Insert a stored error diagnostic into output.
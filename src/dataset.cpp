@@ -40,6 +40,16 @@
 #include "io.h"
 #include "diagnostic.h"
 #include "line_despatch.h"
+#include "stats.h"
+#include "trace.h"
+#include "profile.h"
+#include "file_budget.h"
+#include "progress_meter.h"
+#include "symbol_index.h"
+#include "compile_db.h"
+#include "expansion_cache.h"
+#include "exclude_rules.h"
+#include "reference_cache.h"
 #include <iostream>
 #include <algorithm>
 
@@ -91,7 +101,10 @@ dataset::selector::selector(string const & extensions)
 bool dataset::selector::operator()(string const & filename)
 {
 	bool verdict = false;
-	if (!_filter_extensions.size()) {
+	if (exclude_rules::excludes_file(filename)) {
+		progress_excluded() <<
+			"Excluding file \"" << filename << '\"' << emit();
+	} else if (!_filter_extensions.size()) {
 		verdict = true;
 	} else {
 		size_t leaf_off = filename.find_last_of(PATH_DELIM);
@@ -110,23 +123,68 @@ bool dataset::selector::operator()(string const & filename)
 	}
 	if (verdict) {
 		_files += verdict;
+		progress_meter::add_file(filename);
 		progress_added_file() <<
 			"To do (" << _files << ") \"" << filename << '\"' << emit();
 	}
 	return verdict;
 }
 
+bool dataset::selector::admits_dir(string const & dirname) const
+{
+	if (exclude_rules::excludes_dir(dirname)) {
+		progress_excluded() <<
+			"Excluding directory \"" << dirname << '\"' << emit();
+		return false;
+	}
+	return true;
+}
+
 void dataset::driver::at_file(string const & filename)
 {
 	unsigned error = 0;
-	line_type lineval;
-	if_control::top();
+	if (shard::on() && !shard::contains(_ordinal++)) {
+		return;
+	}
+	if (symbol_index::on() && symbol_index::unaffected(filename)) {
+		progress_skipping_file() << "Skipping unaffected file (" <<
+			++_done_files << ") \"" << filename << '\"' << emit();
+		progress_meter::file_done(filename);
+		return;
+	}
+	stats::timer timing(stats::phase::reading);
+	trace::span tracing("file");
+	if (tracing) {
+		tracing.name(filename);
+	}
+	profile::file_timer profiling(filename);
 	progress_processing_file() << "Processing file (" <<
 		++_done_files << ") \""	<< filename << '\"' << emit();
+	bool configured = compile_db::on() && compile_db::select(filename);
+	symbol_index::top();
+	error = process(filename);
+	symbol_index::done(filename,!error && !file_budget::abandoned());
+	if (configured) {
+		compile_db::deselect();
+	}
+	if (error) {
+		++_error_files;
+		profiling.abandon();
+	}
+	progress_meter::file_done(filename);
+}
+
+unsigned dataset::driver::process(string const & filename)
+{
+	unsigned error = 0;
+	line_type lineval;
+	file_budget::top();
+	if_control::top();
 	io::open(filename);
 	try {
 		while ((lineval = line_despatch::next()) != LT_EOF) {
 			line_debug(0);
+			progress_meter::poll();
 			if (lineval == LT_DIRECTIVE_DROP) {
 				line_despatch::drop();
 			} else {
@@ -135,15 +193,71 @@ void dataset::driver::at_file(string const & filename)
 		}
 	} catch(unsigned ex) {
 		error = ex;
-		++_error_files;
-
+		/* Diagnostics deferred in the abandoned file must not be
+			issued again at the end of the next one */
+		diagnostic_base::discard_all();
 	}
 	io::close(error);
+	if (file_budget::abandoned()) {
+		/* References left unresolved for want of budget must not be
+			recalled for other files */
+		reference_cache::clear();
+	}
+	return error;
+}
+
+void dataset::partition()
+{
+	struct sizer : file_tree::traverser {
+		void at_file(string const & filename) override {
+			names.push_back(filename);
+			sizes.push_back(fs::file_size(filename));
+		}
+		vector<string> names;
+		vector<unsigned long long> sizes;
+	} sizing;
+	_ftree_.traverse(sizing);
+	shard::partition(sizing.sizes);
+	for (unsigned i = 0; i < sizing.names.size(); ++i) {
+		if (!shard::contains(i)) {
+			progress_meter::drop_file(sizing.names[i]);
+		}
+	}
+	progress_file_tracker() << files() <<
+		" files in shard to process" << emit();
+}
+
+void dataset::traverse()
+{
+	if (shard::on()) {
+		partition();
+	}
+	if (symbol_index::on()) {
+		symbol_index::load();
+	}
+	if (expansion_cache::on()) {
+		expansion_cache::load();
+	}
+	progress_meter::start();
+	_ftree_.traverse(_driver_);
+	if (symbol_index::on()) {
+		symbol_index::save();
+	}
+	if (expansion_cache::on()) {
+		expansion_cache::save();
+	}
 }
 
 void dataset::add(string const & path)
 {
+	stats::timer timing(stats::phase::discovery);
 	_ftree_.add(path,_selector_);
 }
 
+void dataset::add(vector<string> const & files)
+{
+	stats::timer timing(stats::phase::discovery);
+	_ftree_.add(files.begin(),files.end(),_selector_);
+}
+
 /* EOF*/
@@ -39,6 +39,8 @@
 
 #include "prohibit.h"
 #include "file_tree.h"
+#include "shard.h"
+#include <vector>
 
 /** \file dataset.h
  *   This defines class `dataset`.
@@ -70,6 +72,13 @@ struct dataset : private no_copy {
 		 */
 		bool operator()(std::string const & filename);
 
+		/** \brief Say whether the files beneath a directory may be
+		 *	selected for processing.
+		 *   \param  dirname    The name of the directory to be tested.
+		 *   \return False iff the directory is excluded by `--exclude-dir`.
+		 */
+		bool admits_dir(std::string const & dirname) const;
+
 		/// Get the number of files so far selected.
 		unsigned files() const {
 			return _files;
@@ -100,6 +109,15 @@ struct dataset : private no_copy {
 		void at_file(std::string const & filename);
 
 	private:
+
+		/** \brief Process a file once, under the operative configuration.
+		 *	\param filename The name of the file.
+		 *	\return 0 if the file was processed without error, else
+		 *		the reason code of the error that aborted processing.
+		 */
+		unsigned process(std::string const & filename);
+		/// The ordinal of the next file in the order of traversal.
+		unsigned _ordinal = 0;
 		/// The number of files reached.
 		unsigned _done_files = 0;
 		/// The number of files abandoned due to errors.
@@ -126,14 +144,22 @@ struct dataset : private no_copy {
     */
 	static void add(std::string const & path);
 
+	/** \brief Add a batch of files to the `dataset`.
+     *
+	 *	\param	files	Names of files to be included in the `dataset`.
+     *
+	 *  Each of `files` that satisfies any `--filter` option is added.
+    */
+	static void add(std::vector<std::string> const & files);
+
 	/// Traverse the dataset processing the selected files.
-	static void traverse() {
-		_ftree_.traverse(_driver_);
-	}
+	static void traverse();
 
-	/// Get the number of files in the `dataset`.
+	/** \brief Get the number of files in the `dataset`, or in the
+	 *	shard of the `dataset` to be processed once it is partitioned.
+	 */
 	static unsigned files() {
-		return _selector_.files();
+		return shard::partitioned() ? shard::files() : _selector_.files();
 	}
 
 	/// Get the number of files reached by traversal of the `dataset`
@@ -150,6 +176,9 @@ struct dataset : private no_copy {
 
 private:
 
+	/// Partition the `dataset` for `--shard`.
+	static void partition();
+
 	/// The `selector` for including files in the `dataset`
 	static selector _selector_;
 	/// The `driver` for traversing `dataset`
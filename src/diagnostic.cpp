@@ -40,6 +40,9 @@
 #include "line_despatch.h"
 #include "options.h"
 #include "io.h"
+#include "stats.h"
+#include "trace.h"
+#include "profile.h"
 #include <iostream>
 #include <iomanip>
 
@@ -55,6 +58,8 @@ unsigned diagnostic_base::_errors_(0);
 unsigned diagnostic_base::_abends_(0);
 unsigned diagnostic_base::_error_directives_generated_(0);
 unsigned diagnostic_base::_error_directives_operative_(0);
+int diagnostic_base::_merged_exitcode_(0);
+unsigned diagnostic_base::_raised_(0);
 
 list<diagnostic_base::ptr> diagnostic_base::_queue_;
 
@@ -63,7 +68,9 @@ diagnostic_base::diagnostic_base(std::string const & severity_name,
                                  bool in_code_only)
 	: _gagged(false)
 {
+	stats::timer timing(stats::phase::diagnostics);
 	unsigned reason = code(level,id);
+	++_raised_;
 
 	if (options::diagnostic_gagged(reason)) {
 		/* This message is filtered out. Don't output*/
@@ -86,6 +93,7 @@ diagnostic_base::diagnostic_base(std::string const & severity_name,
 
 void diagnostic_base::despatch() const throw(unsigned)
 {
+	stats::timer timing(stats::phase::diagnostics);
 	count();
 	if (!text().empty()) {
 		cerr << text() << '\n';
@@ -151,6 +159,16 @@ void diagnostic_base::epilogue()
 			}
 		}
 	}
+	if (options::stats()) {
+		stats::report(cerr);
+	}
+	if (profile::top_symbols()) {
+		profile::report_symbols(cerr);
+	}
+	if (profile::files()) {
+		profile::report_files(cerr);
+	}
+	trace::close();
 }
 
 int diagnostic_base::exitcode()
@@ -185,6 +203,8 @@ int diagnostic_base::exitcode()
 	if (_abends_) {
 		severities |= 8;
 	}
+	severities |= _merged_exitcode_ & 15;
+	summaries |= _merged_exitcode_ & ~15;
 	return severities < 4 ? severities | summaries : severities;
 }
 
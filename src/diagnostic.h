@@ -284,6 +284,23 @@ struct diagnostic_base : private no_assign {
 	 */
 	static int exitcode();
 
+	/** \brief Combine the exit code of another coan run with the
+	 *	exit code of this one.
+	 *
+	 *	The severity and summary bits of `code` are added to those of
+	 *	`exitcode()`, which then combines them as it does its own.
+	 */
+	static void merge_exitcode(int code) {
+		_merged_exitcode_ |= code;
+	}
+
+	/** \brief Get the number of diagnostics raised so far, whether or
+	 *	not they were gagged, deferred or emitted.
+	 */
+	static unsigned raised() {
+		return _raised_;
+	}
+
 protected:
 
 	/// Increment global counts appropriately for the runtime type.
@@ -334,6 +351,10 @@ protected:
 	static unsigned _error_directives_generated_;
 	/// Global count of operative `#error` directives output.
 	static unsigned _error_directives_operative_;
+	/// The bitwise union of the exit codes of other runs merged with this one.
+	static int _merged_exitcode_;
+	/// Global count of diagnostics raised.
+	static unsigned _raised_;
 
 private:
 
@@ -580,6 +601,10 @@ using  progress_added_file = progress_msg<3>;
 using  progress_file_tracker = progress_msg<4>;
 /// Report a commandline argument parsed.
 using progress_got_options = progress_msg<5>;
+/// Report a file skipped as unaffected since it was indexed.
+using progress_skipping_file = progress_msg<6>;
+/// Report a file or directory excluded from input.
+using progress_excluded = progress_msg<7>;
 /// Report a duplicate diagnostic selection option
 using  info_duplicate_mask = info_msg<1>;
 /// Report that input file or directory is symbolic link.
@@ -719,6 +744,18 @@ using warning_not_a_line_number = warning_msg<33>;
 using warning_inconsistent_calls = warning_msg<34>;
 /// Report a macro reference not fully expanded.
 using warning_incomplete_expansion = warning_msg<35>;
+/// Report that a file exceeded its time or macro-expansion budget.
+using warning_budget_exhausted = warning_msg<36>;
+/// Report that the `--index` file is not valid.
+using warning_bad_index = warning_msg<37>;
+/// Report that a file in the compilation database does not exist.
+using warning_missing_db_file = warning_msg<38>;
+/** \brief Report that a file has different configurations in the
+ *	compilation database.
+ */
+using warning_multiply_configured = warning_msg<39>;
+/// Report that the expansion cache file is not valid.
+using warning_bad_expansion_cache = warning_msg<40>;
 
 /// Report an orphan `#elif` was found in input
 using error_orphan_elif = error_msg<1>;
@@ -816,6 +853,10 @@ using abend_invalid_spin_dir = abend_msg<14>;
 using abend_cant_get_cwd = abend_msg<15>;
 /// Report can't create directory
 using abend_cant_create_dir = abend_msg<16>;
+/// Report that the compilation database is not valid JSON.
+using abend_invalid_compile_db = abend_msg<17>;
+/// Report that a precompiled configuration is not valid.
+using abend_invalid_config_snapshot = abend_msg<18>;
 
 
 //! Report processing complete
@@ -44,7 +44,12 @@
 #include "contradiction.h"
 #include "canonical.h"
 #include "symbol.h"
+#include "identifier.h"
+#include "stats.h"
+#include "trace.h"
+#include "file_budget.h"
 #include <iostream>
+#include <cstring>
 
 /** \file directive.cpp
  *	This file implements specializations of `template struct directive<Type>`
@@ -107,31 +112,101 @@ vector<directive_base::evaluator> directive_base::_evaluator_tab_ = {
 	&directive<HASH_ERROR>::eval,
 	&directive<HASH_LINE>::eval
 };
-map<string, directive_type>
-directive_base::_keyword_to_type_map_ = {
-	{	string(TOK_IF),         	HASH_IF },
-	{	string(TOK_IFDEF),      	HASH_IFDEF },
-	{	string(TOK_IFNDEF),     	HASH_IFNDEF},
-	{	string(TOK_ELSE),       	HASH_ELSE },
-	{	string(TOK_ELIF),       	HASH_ELIF },
-	{	string(TOK_ENDIF),      	HASH_ENDIF },
-	{	string(TOK_DEFINE),     	HASH_DEFINE },
-	{	string(TOK_UNDEF),      	HASH_UNDEF },
-	{	string(TOK_INCLUDE),    	HASH_INCLUDE },
-	{	string(TOK_PRAGMA),     	HASH_PRAGMA },
-	{	string(TOK_ERROR),      	HASH_ERROR },
-	{	string(TOK_LINE),			HASH_LINE }
-};
+namespace {
+
+/// The length of the longest directive keyword.
+size_t const max_keyword_len = sizeof(TOK_INCLUDE) - 1;
+
+/** \brief Perfect hash of the directive keywords.
+ *
+ *	The hash is perfect for the keywords of `directive_type`s, as is
+ *	enforced by the `case` labels of `keyword_type()`, which
+ *	must be distinct.
+ */
+constexpr unsigned keyword_hash(char const * kw, size_t len)
+{
+	return (len + 3 * (kw[0] + kw[len - 1])) & 31;
+}
+
+/// Perfect hash of a literal directive keyword
+template<size_t N>
+constexpr unsigned keyword_hash(char const (&tok)[N])
+{
+	return keyword_hash(tok,N - 1);
+}
+
+/// Say whether a keyword of length `len` is literal keyword `tok`
+template<size_t N>
+bool keyword_match(char const * kw, size_t len, char const (&tok)[N])
+{
+	return len == N - 1 && !memcmp(kw,tok,len);
+}
+
+/** \brief Get the `directive_type` of a keyword.
+ *	\param kw Pointer to the keyword
+ *	\param len Length of the keyword, which is at least 1 and
+ *		at most `max_keyword_len`.
+ */
+directive_type keyword_type(char const * kw, size_t len)
+{
+	switch(keyword_hash(kw,len)) {
+	case keyword_hash(TOK_IF):
+		return keyword_match(kw,len,TOK_IF) ? HASH_IF : HASH_UNKNOWN;
+	case keyword_hash(TOK_IFDEF):
+		return keyword_match(kw,len,TOK_IFDEF) ? HASH_IFDEF : HASH_UNKNOWN;
+	case keyword_hash(TOK_IFNDEF):
+		return keyword_match(kw,len,TOK_IFNDEF) ? HASH_IFNDEF : HASH_UNKNOWN;
+	case keyword_hash(TOK_ELSE):
+		return keyword_match(kw,len,TOK_ELSE) ? HASH_ELSE : HASH_UNKNOWN;
+	case keyword_hash(TOK_ELIF):
+		return keyword_match(kw,len,TOK_ELIF) ? HASH_ELIF : HASH_UNKNOWN;
+	case keyword_hash(TOK_ENDIF):
+		return keyword_match(kw,len,TOK_ENDIF) ? HASH_ENDIF : HASH_UNKNOWN;
+	case keyword_hash(TOK_DEFINE):
+		return keyword_match(kw,len,TOK_DEFINE) ? HASH_DEFINE : HASH_UNKNOWN;
+	case keyword_hash(TOK_UNDEF):
+		return keyword_match(kw,len,TOK_UNDEF) ? HASH_UNDEF : HASH_UNKNOWN;
+	case keyword_hash(TOK_INCLUDE):
+		return keyword_match(kw,len,TOK_INCLUDE) ? HASH_INCLUDE : HASH_UNKNOWN;
+	case keyword_hash(TOK_PRAGMA):
+		return keyword_match(kw,len,TOK_PRAGMA) ? HASH_PRAGMA : HASH_UNKNOWN;
+	case keyword_hash(TOK_ERROR):
+		return keyword_match(kw,len,TOK_ERROR) ? HASH_ERROR : HASH_UNKNOWN;
+	case keyword_hash(TOK_LINE):
+		return keyword_match(kw,len,TOK_LINE) ? HASH_LINE : HASH_UNKNOWN;
+	default:
+		return HASH_UNKNOWN;
+	}
+}
+
+} // namespace
 
-directive_type directive_base::get_type(std::string const & keyword)
+directive_type
+directive_base::get_type(chewer<parse_buffer> & chew, size_t & len)
 {
-	auto where = _keyword_to_type_map_.find(keyword);
-	if (where == _keyword_to_type_map_.end()) {
+	size_t const start = size_t(chew);
+	char kw[max_keyword_len];
+	len = 0;
+	chew(continuation);
+	if (chew && identifier::is_start_char(*chew)) {
+		for (	;chew && identifier::is_valid_char(*chew);
+				chew(+1,continuation), ++len) {
+			if (len < max_keyword_len) {
+				kw[len] = *chew;
+			}
+		}
+	}
+	directive_type type = HASH_UNKNOWN;
+	if (len && len <= max_keyword_len) {
+		type = keyword_type(kw,len);
+	}
+	if (type == HASH_UNKNOWN) {
+		chew = start;
+		string keyword = canonical<symbol>(chew);
 		warning_unknown_directive() << "Unknown directive #"
 		                            << keyword << emit();
-		return HASH_UNKNOWN;
 	}
-	return where->second;
+	return type;
 }
 
 void directive_base::report(std::string const & keyword,
@@ -169,7 +244,9 @@ directive_base::eval_ifdef_or_ifndef(
 	symbol::locator sloc(chew);
 	chew(greyspace);
 	line_type retval = LT_IF;
-	if (sloc->configured()) {
+	if (file_budget::exhausted()) {
+		/* Leave unresolved */
+	} else if (sloc->configured()) {
 		if (sloc->defined()) {
 			/* symbol is -Ded*/
 			retval = type == HASH_IFDEF ?
@@ -189,6 +266,24 @@ directive_base::eval_ifdef_or_ifndef(
 	return retval;
 }
 
+line_type directive_base::eval(chewer<parse_buffer> & chew)
+{
+	size_t keyword_off = size_t(chew);
+	size_t keyword_len;
+	directive_type type = get_type(chew,keyword_len);
+	line_despatch::cur_line().mark_keyword(keyword_off,keyword_len);
+	stats::timer timing(stats::phase::evaluation);
+	trace::span tracing("directive",trace::directive_threshold());
+	if (tracing) {
+		tracing.name(string("#") + keyword(type));
+		tracing.arg("file",io::in_file_name());
+		tracing.arg("line",line_despatch::cur_line().num());
+	}
+	line_type retval = eval(type,chew);
+	stats::count_directive(type,retval);
+	return retval;
+}
+
 line_type directive_base::eval(directive_type type, chewer<parse_buffer> & chew)
 {
 	chew(greyspace);
@@ -214,6 +309,16 @@ line_type directive_base::eval(directive_type type, chewer<parse_buffer> & chew)
 	return retval;
 }
 
+char const * directive_base::keyword(directive_type type)
+{
+	static char const * const keywords[] = {
+		"unknown", TOK_IF, TOK_IFDEF, TOK_IFNDEF, TOK_ELSE, TOK_ELIF,
+		TOK_ENDIF, TOK_DEFINE, TOK_UNDEF, TOK_INCLUDE, TOK_PRAGMA,
+		TOK_ERROR, TOK_LINE
+	};
+	return keywords[type];
+}
+
 void directive_base::erase_all() {
 	auto command = options::get_command();
 	if (command == CMD_INCLUDES || command == CMD_DIRECTIVES) {
@@ -249,6 +354,9 @@ line_type directive<HASH_IF>::eval(chewer<parse_buffer> & chew)
 	if (!chew) {
 		error_if_without_cond() << "#if/elif has no argument." << emit();
 	}
+	if (file_budget::exhausted()) {
+		return lineval;
+	}
 	if (!options::eval_wip()) {
 		size_t mark = size_t(chew);
 		integer i = integer_constant::read_numeral(chew);
@@ -54,21 +54,41 @@
 struct directive_base : private no_copy
 {
 	/** \brief Evaluate a directive
-	 *  \param  keyword The keyword indicating the directive type.
 	 *  \param  chew  On entry, a `chewer<parse_buffer>` positioned to the
-	 *      offset in the associated `parse_buffer` from which to to scan.
-	 *			On return receives `chew` is positioned to the first
-	 *			offset not consumed.
+	 *      offset in the associated `parse_buffer` at which the directive
+	 *			keyword starts. On return `chew` is positioned to the
+	 *			first offset not consumed.
 	 *   \return A `line_type` determined by evaluation
 	 *       denoting the action to be taken on this line.
+	 *
+	 *	The directive keyword is recognized in place in the line, and
+	 *	its offset and length recorded in the current line.
 	 */
-	static line_type eval(std::string keyword, chewer<parse_buffer> & chew) {
-		return eval(get_type(keyword),chew);
-	}
+	static line_type eval(chewer<parse_buffer> & chew);
 
 	/// Forget all directives table used by the operative command.
 	static void erase_all();
 
+	/** \brief Get the keyword of a directive type.
+	 *  \param  type A `directive_type` other than `COMMANDLINE`.
+	 *  \return The keyword, or "unknown" for `HASH_UNKNOWN`.
+	 */
+	static char const * keyword(directive_type type);
+
+	/** \brief Get the `directive_type` of a directive keyword
+	 *	\param  chew  On entry, a `chewer<parse_buffer>` positioned to the
+	 *      offset at which the keyword starts. On return `chew` is
+	 *		positioned past the keyword.
+	 *	\param  len On return, the length of the keyword, exclusive of any
+	 *		line-continuations within it.
+	 *	\return The `directive_type` denoted by the keyword, or
+	 *		`HASH_UNKNOWN` if it is not a directive keyword.
+	 *
+	 *	The keyword is matched against the known keywords without
+	 *	constructing a string, unless it is unknown and must be diagnosed.
+	 */
+	static directive_type get_type(chewer<parse_buffer> & chew, size_t & len);
+
 protected:
 
 	/** \brief Report a directive
@@ -113,10 +133,6 @@ private:
 
 	/// Type of evaluation functions applied to directive bodies
 	using evaluator = line_type (*)(chewer<parse_buffer> &);
-	/// Get the `directive_type` of a directive given a keyword
-	static directive_type get_type(std::string const & keyword);
-	/// Map from keywords to directive types.
-	static std::map<std::string, directive_type> _keyword_to_type_map_;
 	/** \brief Table of evaluation functions for directive types, indexed
 	 *   by `directive_type`.
 	 */
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "exclude_rules.h"
+#include "platform.h"
+
+/** \file exclude_rules.cpp
+ *   This file implements `struct exclude_rules`
+ */
+
+using namespace std;
+
+exclude_rules::rule_set exclude_rules::_files_;
+exclude_rules::rule_set exclude_rules::_dirs_;
+
+namespace {
+
+/// Does `\` escape the next character of a pattern?
+bool const backslash_escapes = PATH_DELIM != '\\';
+
+/** \brief Match a character against a bracketed character class.
+ *	\param p On entry, points to the `[` that opens the class. On return,
+ *		points past the class.
+ *	\param pe The end of the pattern.
+ *	\param c The character to match.
+ *	\return True if `c` matches the class.
+ *
+ *	A `[` that is not closed matches itself.
+ */
+bool class_match(char const * & p, char const * pe, char c)
+{
+	char const * open = p++;
+	bool negate = p < pe && (*p == '!' || *p == '^');
+	p += negate;
+	bool hit = false;
+	for (bool first = true; p < pe && (*p != ']' || first); first = false) {
+		unsigned char lo = *p++;
+		unsigned char hi = lo;
+		if (p + 1 < pe && *p == '-' && p[1] != ']') {
+			hi = p[1];
+			p += 2;
+		}
+		hit = hit || (lo <= (unsigned char)c && (unsigned char)c <= hi);
+	}
+	if (p == pe) {
+		p = open + 1;
+		return c == '[';
+	}
+	++p;
+	return hit != negate && c != PATH_DELIM;
+}
+
+/** \brief Match text against a glob pattern.
+ *	\param p The start of the pattern.
+ *	\param pe The end of the pattern.
+ *	\param s The start of the text.
+ *	\param se The end of the text.
+ *	\return True if the whole text matches the whole pattern.
+ */
+bool glob_match(char const * p, char const * pe, char const * s,
+	char const * se)
+{
+	char const * star_p = nullptr;
+	char const * star_s = nullptr;
+	while (s < se) {
+		if (p < pe && *p == '*') {
+			star_p = ++p;
+			star_s = s;
+			continue;
+		}
+		if (p < pe) {
+			char const * q = p;
+			bool ok;
+			if (*q == '?') {
+				ok = *s != PATH_DELIM;
+				++q;
+			} else if (*q == '[') {
+				ok = class_match(q,pe,*s);
+			} else {
+				if (*q == '\\' && backslash_escapes && q + 1 < pe) {
+					++q;
+				}
+				ok = *q++ == *s;
+			}
+			if (ok) {
+				p = q;
+				++s;
+				continue;
+			}
+		}
+		/* Let the latest `*` absorb one more character, if it can */
+		if (!star_p || *star_s == PATH_DELIM) {
+			return false;
+		}
+		p = star_p;
+		s = ++star_s;
+	}
+	while (p < pe && *p == '*') {
+		++p;
+	}
+	return p == pe;
+}
+
+/// Match text against a glob pattern.
+bool glob_match(string const & pattern, char const * s, char const * se)
+{
+	char const * p = pattern.data();
+	return glob_match(p,p + pattern.size(),s,se);
+}
+
+} // namespace
+
+void exclude_rules::rule_set::add(string pattern)
+{
+	if (PATH_DELIM != '/') {
+		for (char & c : pattern) {
+			c = c == '/' ? PATH_DELIM : c;
+		}
+	}
+	while (pattern.size() > 1 && pattern[pattern.size() - 1] == PATH_DELIM) {
+		pattern.resize(pattern.size() - 1);
+	}
+	if (pattern.empty()) {
+		return;
+	}
+	if (pattern.find(PATH_DELIM) != string::npos) {
+		_path_globs.push_back(pattern);
+	} else if (pattern.find_first_of(backslash_escapes ? "*?[\\" : "*?[") !=
+			string::npos) {
+		_name_globs.push_back(pattern);
+	} else {
+		_names.insert(pattern);
+	}
+}
+
+bool exclude_rules::rule_set::matches(string const & path) const
+{
+	size_t leaf = path.find_last_of(PATH_DELIM);
+	leaf = leaf == string::npos ? 0 : leaf + 1;
+	char const * start = path.data();
+	char const * end = start + path.size();
+	if (!_names.empty() && _names.count(path.substr(leaf))) {
+		return true;
+	}
+	for (string const & glob : _name_globs) {
+		if (glob_match(glob,start + leaf,end)) {
+			return true;
+		}
+	}
+	for (string const & glob : _path_globs) {
+		if (glob[0] == PATH_DELIM) {
+			if (glob_match(glob,start,end)) {
+				return true;
+			}
+			continue;
+		}
+		for (char const * s = start; s < end; ++s) {
+			if ((s == start || s[-1] == PATH_DELIM) &&
+					glob_match(glob,s,end)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// EOF
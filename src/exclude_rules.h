@@ -0,0 +1,122 @@
+#ifndef EXCLUDE_RULES_H
+#define EXCLUDE_RULES_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+#include <set>
+
+/** \file exclude_rules.h
+ *   This file defines `struct exclude_rules`
+ */
+
+/** \brief `struct exclude_rules` decides which files and directories are
+ *	excluded from the input dataset by the `--exclude` and `--exclude-dir`
+ *	options.
+ *
+ *  Each option gives a glob pattern in which `*` matches any sequence of
+ *	characters, `?` matches any one character, `[...]` matches any one of
+ *	the bracketed characters or ranges, or `[!...]` any other, and `\`
+ *	escapes the next character where it is not the path delimiter. `*` and
+ *	`?` do not match the path delimiter.
+ *
+ *	A pattern that contains no path delimiter is matched against the last
+ *	element of a path. Otherwise an absolute pattern is matched against the
+ *	whole path and a relative pattern against every trailing sequence
+ *	of elements of the path.
+ *
+ *	The patterns are sorted once, as they are given, so that patterns
+ *	without wildcards are looked up by name and only the others are matched.
+ *	An excluded directory is pruned from discovery of the input files before
+ *	it is opened, so nothing beneath it is read.
+ */
+struct exclude_rules {
+
+	/** \brief Add a pattern for files to be excluded.
+	 *	\param pattern The argument of an `--exclude` option.
+	 */
+	static void add_file_pattern(std::string const & pattern) {
+		_files_.add(pattern);
+	}
+
+	/** \brief Add a pattern for directories to be excluded.
+	 *	\param pattern The argument of an `--exclude-dir` option.
+	 */
+	static void add_dir_pattern(std::string const & pattern) {
+		_dirs_.add(pattern);
+	}
+
+	/// Say whether a file is excluded.
+	static bool excludes_file(std::string const & path) {
+		return !_files_.empty() && _files_.matches(path);
+	}
+
+	/// Say whether a directory is excluded.
+	static bool excludes_dir(std::string const & path) {
+		return !_dirs_.empty() && _dirs_.matches(path);
+	}
+
+private:
+
+	/// A set of patterns of one kind.
+	struct rule_set {
+
+		/// Add a pattern to the set.
+		void add(std::string pattern);
+
+		/// Say whether the set is empty.
+		bool empty() const {
+			return _names.empty() && _name_globs.empty() && _path_globs.empty();
+		}
+
+		/// Say whether a path matches any pattern in the set.
+		bool matches(std::string const & path) const;
+
+	private:
+		/// Patterns for the last element of a path without wildcards.
+		std::set<std::string> _names;
+		/// Patterns for the last element of a path with wildcards.
+		std::vector<std::string> _name_globs;
+		/// Patterns for more than one element of a path.
+		std::vector<std::string> _path_globs;
+	};
+
+	/// The patterns for excluded files.
+	static rule_set _files_;
+	/// The patterns for excluded directories.
+	static rule_set _dirs_;
+};
+
+#endif // EOF
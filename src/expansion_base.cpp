@@ -82,34 +82,38 @@ expansion_base::expansion_base(reference const & ref)
 	}
 }
 
-void expansion_base::set_expansion_flags()
+expansion_base::expansion_base(reference && ref)
+: 	reference(std::move(ref)),
+	_value(reference::invocation())
 {
+	if (callee()->configured() && args() && callee()->parameters()) {
+		set_expansion_flags();
+	}
+}
 
-	chewer<string> chew(chew_mode::plaintext,
-        const_cast<string &>(callee()->format()->str()));
-	for (chew(literal_space); chew; chew(literal_space)) {
-		specifier spec = specifier::read(chew);
-		if (spec) {
-			size_t param_i = spec.get_param_index();
-			switch(spec.get_handling()) {
-			case handling::substitute_arg:
-				args().set_expandable(param_i,false);
-				break;
-			case handling::substitute_quoted_arg: {
-				args().set_expandable(param_i,false);
-				auto quoted_arg = quote(args().at(param_i));
-				args()[param_i] = quoted_arg;
-				break;
-            }
-			case handling::substitute_expanded_arg:
-				args().set_expandable(param_i,true);
-				break;
-			default:
-				assert(false);
-			}
+void expansion_base::set_expansion_flags()
+{
+	for (auto const & tok : callee()->format()->tokens()) {
+		if (!tok.spec) {
 			continue;
 		}
-		++chew;
+		size_t param_i = tok.spec.get_param_index();
+		switch(tok.spec.get_handling()) {
+		case handling::substitute_arg:
+			args().set_expandable(param_i,false);
+			break;
+		case handling::substitute_quoted_arg: {
+			args().set_expandable(param_i,false);
+			auto quoted_arg = quote(args().at(param_i));
+			args()[param_i] = quoted_arg;
+			break;
+		}
+		case handling::substitute_expanded_arg:
+			args().set_expandable(param_i,true);
+			break;
+		default:
+			assert(false);
+		}
 	}
 }
 
@@ -150,33 +154,28 @@ unsigned expansion_base::edit_trailing_args(
 
 bool expansion_base::substitute()
 {
-    string s;
-    string & format = const_cast<string &>(callee()->format()->str());
-	chewer<string> chew(chew_mode::plaintext,format);
-    while (chew) {
-        size_t mark = size_t(chew);
-        chew(literal_space);
-        if (size_t(chew) > mark) {
-            s += format.substr(mark,size_t(chew) - mark);
-        }
-        specifier spec = specifier::read(chew);
-        if (spec) {
-            size_t param_i = spec.get_param_index();
-            size_t next_size = s.size() + args().at(param_i).size();
-            if (next_size > max_expansion_size()) {
-                warning_incomplete_expansion()
-                << "Argument substitution in \"" << this->reference::invocation()
-                << "\" not done. Will exceed max expansion size "
-                << max_expansion_size() << " bytes" << emit();
-                s = _value;
-                break;
-            }
-            s += args().at(param_i);
-        } else if (chew) {
-            s += *chew;
-            ++chew;
-        }
-    }
+	string s;
+	auto format = callee()->format();
+	if (format) {
+		string const & fmt = format->str();
+		for (auto const & tok : format->tokens()) {
+			if (!tok.spec) {
+				s.append(fmt,tok.off,tok.len);
+				continue;
+			}
+			size_t param_i = tok.spec.get_param_index();
+			size_t next_size = s.size() + args().at(param_i).size();
+			if (next_size > max_expansion_size()) {
+				warning_incomplete_expansion()
+				<< "Argument substitution in \"" << this->reference::invocation()
+				<< "\" not done. Will exceed max expansion size "
+				<< max_expansion_size() << " bytes" << emit();
+				s = _value;
+				break;
+			}
+			s += args().at(param_i);
+		}
+	}
 	if (s != _value) {
 		_value = s;
 		return true;
@@ -37,6 +37,7 @@
  *                                                                         *
  **************************************************************************/
 #include "reference.h"
+#include "options.h"
 #include <string>
 #include <memory>
 
@@ -52,11 +53,19 @@ struct expansion_base : reference
 	/// Construct from a reference
 	explicit expansion_base(reference const & ref);
 
+	/// Construct from a reference that is moved
+	explicit expansion_base(reference && ref);
+
 	/// Get the current expanded value of the reference
 	std::string const & value() const {
         return _value;
 	}
 
+	/// Move the expanded value out of the expansion when done with it
+	std::string take_value() {
+        return std::move(_value);
+	}
+
 	/** \brief Perform the expansion of the reference returning the
      *   total number of edits applied
      */
@@ -88,9 +97,15 @@ struct expansion_base : reference
 	static std::unique_ptr<expansion_base>
 	factory(bool explain, reference const & ref);
 
-	/// Cut-off size for macro-expansions
-	static constexpr unsigned max_expansion_size() {
-	    return 4196;
+	/** \brief Cut-off size for macro-expansions, as set by `--max-expansion`
+	 *
+	 *  Expansions are edited in place in a contiguous `std::string`, since
+	 *  rescanning, argument parsing and `--explain` all need contiguous
+	 *  text. The limit therefore bounds the cost of the edit-and-rescan
+	 *  loop. A rope or piece-table expansion buffer is deferred.
+	 */
+	static unsigned max_expansion_size() {
+	    return options::max_expansion();
 	}
 
 protected:
@@ -157,6 +172,17 @@ protected:
 		expansion_base const & e,
 		size_t start = 0);
 
+	/** \brief Say whether the value of the expansion is known to contain
+	 *	no references, so it need not be re-scanned for them.
+	 *
+	 *	This is so when the reference has no arguments and the definition
+	 *	of the referenced symbol, if any, contains no identifiers.
+	 */
+	bool nothing_to_rescan() const {
+		return !args() &&
+			(!callee()->format() || !callee()->format()->has_names());
+	}
+
 	/// Say whether all arguments are fully expanded
 	bool args_expansion_done() const {
 		return _cur_arg == args().size();
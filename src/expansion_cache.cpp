@@ -0,0 +1,252 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "expansion_cache.h"
+#include "options.h"
+#include "version.h"
+#include "diagnostic.h"
+#include "chew.h"
+#include "identifier.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+/** \file expansion_cache.cpp
+ *   This file implements `struct expansion_cache`
+ */
+
+using namespace std;
+
+string expansion_cache::_filename_;
+map<string,expansion_cache::stored> expansion_cache::_stored_;
+
+/// The first word of a cache file, followed by the configuration hash.
+static char const cache_header[] = "coan expansions 1";
+
+expansion_cache::recorder::recorder(bool explain)
+: 	_outer(symbol::log_invocations(&_invoked)),
+	_raised(diagnostic_base::raised()),
+	_explain(explain),
+	_cout(explain ? cout.rdbuf(_explanation.rdbuf()) : nullptr)
+{}
+
+expansion_cache::recorder::~recorder()
+{
+	symbol::log_invocations(_outer);
+	if (_outer) {
+		_outer->insert(_outer->end(),_invoked.begin(),_invoked.end());
+	}
+	if (_cout) {
+		cout.rdbuf(_cout);
+		cout << _explanation.str();
+	}
+}
+
+void expansion_cache::recorder::keep(string const & key, string const & expansion)
+{
+	stored s;
+	if (diagnostic_base::raised() != _raised ||
+			!unconfigured_names(key,s._unconfigured) ||
+			!unconfigured_names(expansion,s._unconfigured)) {
+		return;
+	}
+	for (symbol::locator const & loc : _invoked) {
+		if (loc->origin() != symbol::provenance::global) {
+			return;
+		}
+		s._invoked.push_back(loc.id());
+	}
+	s._expansion = expansion;
+	s._explained = _explain;
+	if (_explain) {
+		s._explanation = _explanation.str();
+	}
+	_stored_[key] = std::move(s);
+}
+
+void expansion_cache::load()
+{
+	ifstream in(_filename_.c_str(),ios::binary);
+	if (!in.good()) {
+		/* No cache yet */
+		return;
+	}
+	string line;
+	ostringstream header;
+	header << cache_header << ' ' << hex << fingerprint();
+	if (!getline(in,line) || line != header.str()) {
+		/* Written under another configuration */
+		return;
+	}
+	bool good = true;
+	while (good && getline(in,line)) {
+		istringstream fields(line);
+		string tag;
+		size_t key_len = 0, exp_len = 0, expl_len = 0;
+		stored s;
+		good = fields >> tag >> key_len >> exp_len >> s._explained >> expl_len
+			&& tag == "stored";
+		string text(key_len + exp_len + expl_len,'\0');
+		good = good && in.read(&text[0],text.size()) && in.get() == '\n' &&
+			getline(in,line);
+		if (good) {
+			istringstream names(line);
+			string id;
+			names >> tag;
+			good = tag == "invoked";
+			while (names >> id) {
+				s._invoked.push_back(id);
+			}
+			good = good && getline(in,line);
+		}
+		if (good) {
+			istringstream names(line);
+			string id;
+			names >> tag;
+			good = tag == "unconfigured";
+			while (names >> id) {
+				s._unconfigured.push_back(id);
+			}
+			s._expansion = text.substr(key_len,exp_len);
+			s._explanation = text.substr(key_len + exp_len);
+			_stored_[text.substr(0,key_len)] = std::move(s);
+		}
+	}
+	if (!good) {
+		warning_bad_expansion_cache() << "Expansion cache \"" << _filename_ <<
+			"\" is not valid and will be rebuilt" << emit();
+		_stored_.clear();
+	}
+}
+
+void expansion_cache::save()
+{
+	ofstream out(_filename_.c_str(),ios::binary);
+	if (!out.good()) {
+		abend_cant_open_output() << "Can't open " <<
+			_filename_ << " for writing" << emit();
+	}
+	out << cache_header << ' ' << hex << fingerprint() << dec << '\n';
+	for (auto const & entry : _stored_) {
+		stored const & s = entry.second;
+		out << "stored " << entry.first.size() << ' ' <<
+			s._expansion.size() << ' ' << s._explained << ' ' <<
+			s._explanation.size() << '\n' << entry.first << s._expansion <<
+			s._explanation << '\n' << "invoked";
+		for (string const & id : s._invoked) {
+			out << ' ' << id;
+		}
+		out << '\n' << "unconfigured";
+		for (string const & id : s._unconfigured) {
+			out << ' ' << id;
+		}
+		out << '\n';
+	}
+	out.close();
+	if (!out.good()) {
+		abend_cant_write_file() << "Write error on " << _filename_ << emit();
+	}
+}
+
+expansion_cache::stored const *
+expansion_cache::recall(string const & key, bool explain)
+{
+	auto found = _stored_.find(key);
+	if (found == _stored_.end()) {
+		return nullptr;
+	}
+	stored const & s = found->second;
+	if ((explain && !s._explained) ||
+			!consistent(key,s) || !consistent(s._expansion,s)) {
+		return nullptr;
+	}
+	return &s;
+}
+
+bool expansion_cache::unconfigured_names(
+	string const & text,
+	vector<string> & names)
+{
+	chewer<string> chew(chew_mode::plaintext,const_cast<string &>(text));
+	size_t off = 0;
+	for (string id; !(id = identifier::find_any_in(chew,off)).empty(); ) {
+		symbol::locator loc = symbol::lookup(id);
+		if (!loc || loc->origin() == symbol::provenance::global) {
+			continue;
+		}
+		if (loc->origin() == symbol::provenance::transient) {
+			return false;
+		}
+		if (find(names.begin(),names.end(),id) == names.end()) {
+			names.push_back(id);
+		}
+	}
+	return true;
+}
+
+bool expansion_cache::consistent(string const & text, stored const & s)
+{
+	chewer<string> chew(chew_mode::plaintext,const_cast<string &>(text));
+	size_t off = 0;
+	for (string id; !(id = identifier::find_any_in(chew,off)).empty(); ) {
+		symbol::locator loc = symbol::lookup(id);
+		if (!loc || loc->origin() == symbol::provenance::global) {
+			continue;
+		}
+		if (loc->origin() == symbol::provenance::transient ||
+				find(s._unconfigured.begin(),s._unconfigured.end(),id) ==
+					s._unconfigured.end()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+unsigned long long expansion_cache::fingerprint()
+{
+	unsigned long long h = 14695981039346656037ULL;
+	auto mix = [&h](string const & s) {
+		for (char c : s) {
+			h = (h ^ (unsigned char)c) * 1099511628211ULL;
+		}
+		h = (h ^ 0) * 1099511628211ULL;
+	};
+	mix(version_number());
+	mix(to_string(options::max_expansion()));
+	for (string const & arg : options::config_args()) {
+		mix(arg);
+	}
+	return h;
+}
+
+// EOF
@@ -0,0 +1,173 @@
+#ifndef EXPANSION_CACHE_H
+#define EXPANSION_CACHE_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "symbol.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+
+/** \file expansion_cache.h
+ *   This file defines `struct expansion_cache`
+ */
+
+/** \brief `struct expansion_cache` keeps the macro-expansions of references
+ *	of global symbols in a file from one run to the next.
+ *
+ *  With the `--expansion-cache FILE` option, the expansion of a reference
+ *	of a globally configured symbol is stored in `FILE` if it depends on
+ *	nothing but the global configuration. A later run with the same global
+ *	configuration recalls the expansion instead of repeating it, along with
+ *	its explanation if it was explained. The file is keyed by a hash of the
+ *	`--define` and `--undef` options, the `--max-expansion` limit and the
+ *	coan version, and is discarded if the key does not match.
+ *
+ *	The expansion is only stored if it raised no diagnostics and invoked
+ *	only global symbols. It is only recalled if every name in the reference
+ *	and the expansion still denotes a global symbol, no symbol or an
+ *	unconfigured symbol that it denoted when the expansion was stored.
+ */
+struct expansion_cache {
+
+	/// `struct stored` holds a stored expansion.
+	struct stored {
+		/// The expansion.
+		std::string _expansion;
+		/// The explanation of the expansion, if explained.
+		std::string _explanation;
+		/// Was the expansion explained?
+		bool _explained = false;
+		/// The names of the symbols invoked by the expansion.
+		std::vector<std::string> _invoked;
+		/** The names in the reference and the expansion that denoted
+		 *	unconfigured symbols.
+		 */
+		std::vector<std::string> _unconfigured;
+	};
+
+	/** \brief `struct recorder` records the expansion of a reference
+	 *	of a global symbol for storing.
+	 *
+	 *	While a `recorder` exists, invoked symbols are logged and, if
+	 *	the expansion is explained, the explanation written on `cout`
+	 *	is captured, to be written through on destruction.
+	 */
+	struct recorder {
+
+		/** \brief Explicitly construct given whether the expansion
+		 *	is explained.
+		 */
+		explicit recorder(bool explain);
+
+		~recorder();
+
+		/** \brief Store the expansion of a reference.
+		 *	\param key The cache key of the reference.
+		 *	\param expansion The completed expansion.
+		 */
+		void keep(std::string const & key, std::string const & expansion);
+
+	private:
+
+		/// The symbols invoked during the expansion.
+		std::vector<symbol::locator> _invoked;
+		/// The enclosing log of invoked symbols, if any.
+		std::vector<symbol::locator> * _outer;
+		/// The number of diagnostics raised before the expansion.
+		unsigned _raised;
+		/// Is the expansion explained?
+		bool _explain;
+		/// Captures the explanation.
+		std::ostringstream _explanation;
+		/// The stream buffer of `cout` while the explanation is captured.
+		std::streambuf * _cout;
+	};
+
+	/** \brief Specify the cache file.
+	 *	\param filename The argument of the `--expansion-cache` option.
+	 */
+	static void set(std::string const & filename) {
+		_filename_ = filename;
+	}
+
+	/// Say whether the expansion cache is in use.
+	static bool on() {
+		return !_filename_.empty();
+	}
+
+	/** \brief Read the cache file, if it exists and was written under
+	 *	the same global configuration.
+	 */
+	static void load();
+
+	/// Write the cache file.
+	static void save();
+
+	/** \brief Recall the stored expansion of a reference of a global symbol.
+	 *	\param key The cache key of the reference.
+	 *	\param explain Is the expansion to be explained?
+	 *	\return A pointer to the stored expansion, if it can be recalled,
+	 *		else null.
+	 */
+	static stored const * recall(std::string const & key, bool explain);
+
+private:
+
+	/** \brief Collect the names in a string that denote unconfigured
+	 *	symbols.
+	 *	\param text The string to scan.
+	 *	\param names Receives the names not already in it.
+	 *	\return False if any name denotes a transient symbol, else true.
+	 */
+	static bool
+	unconfigured_names(std::string const & text, std::vector<std::string> & names);
+
+	/** \brief Say whether every name in a string denotes either a global
+	 *	symbol, no symbol or an unconfigured symbol that it denoted when
+	 *	an expansion was stored.
+	 */
+	static bool consistent(std::string const & text, stored const & s);
+
+	/// Get the hash of the global configuration.
+	static unsigned long long fingerprint();
+
+	/// The name of the cache file.
+	static std::string _filename_;
+	/// The stored expansions, by cache key.
+	static std::map<std::string,stored> _stored_;
+};
+
+#endif // EOF
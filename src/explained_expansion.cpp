@@ -35,6 +35,8 @@
  **************************************************************************/
 #include "explained_expansion.h"
 #include "diagnostic.h"
+#include "file_budget.h"
+#include "profile.h"
 #include <iostream>
 #include <iomanip>
 
@@ -97,7 +99,7 @@ unsigned explained_expansion::expand()
 		edits += bubble_edit(*this,false);
         report_intermediate_value();
 	}
-	return edits += expand(_value);
+	return nothing_to_rescan() ? edits : edits += expand(_value);
 }
 
 unsigned explained_expansion::expand(string & str)
@@ -112,8 +114,10 @@ unsigned explained_expansion::expand(string & str)
 			chew = off + sym->id().length();
 			continue;
 		}
-		explained_expansion e(ref,this);
+		file_budget::charge_expansion();
+		explained_expansion e(std::move(ref),this);
 		try {
+			profile::digest_timer profiling(sym->id());
             if (!e.expand()) {
                 continue;
 
@@ -128,6 +132,7 @@ unsigned explained_expansion::expand(string & str)
                 throw_self();
             }
 		}
+		profile::charge_expansion(sym->id(),e.value().size());
 		if (str.compare(off,e.value().size(),e.value()) == 0) {
             continue;
 		}
@@ -57,6 +57,17 @@ struct explained_expansion : expansion_base
         explained_expansion * parent = nullptr)
     : 	expansion_base(ref),_parent(parent){}
 
+	/** \brief Explicitly construct from a reference that is moved
+	 *  and optional parent
+	 *  \param ref The reference to be expanded
+	 *  \param parent If not null, then a pointer to the `expansion_base`
+	 *  from whose expansion this one accrues.
+	 */
+    explicit explained_expansion(
+        reference && ref,
+        explained_expansion * parent = nullptr)
+    : 	expansion_base(std::move(ref)),_parent(parent){}
+
 	/** \brief Perform the explained expansion of the reference, returning
      *  the numbe of edits applied.
 	 */
@@ -43,6 +43,7 @@
 #include "options.h"
 #include "line_despatch.h"
 #include "expansion_base.h"
+#include "file_budget.h"
 
 /** \file expression_parser.cpp
  *   This file implements `struct expression_parser`
@@ -684,7 +685,7 @@ expression_parser<CharSeq>::unary_op(chewer<CharSeq> & chew, size_t end)
 					if (!sloc->invoked() && args) {
 						sloc->set_parameters(args.size());
 					}
-					reference ref(sloc,args,_ref);
+					reference ref(sloc,std::move(args),_ref);
 					if (!ref.eval().insoluble() && !ref.args() &&
 							options::implicit()) {
 						result.set_value(0);
@@ -702,7 +703,7 @@ expression_parser<CharSeq>::unary_op(chewer<CharSeq> & chew, size_t end)
 						gripe << '\"' << ref.invocation()
 							<< "\" expands to nothing within expression";
 						defer_diagnostic(gripe);
-					} else if (result.insoluble()) {
+					} else if (result.insoluble() && !file_budget::abandoned()) {
 					    if (ref.complete()) {
                             error_non_term gripe;
                             gripe << '\"' << ref.invocation()
@@ -0,0 +1,76 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "file_budget.h"
+#include "diagnostic.h"
+
+/** \file file_budget.cpp
+ *   This file implements `struct file_budget`
+ */
+
+using namespace std;
+
+unsigned file_budget::_millisecs_ = 0;
+unsigned long file_budget::_expansions_ = 0;
+unsigned long file_budget::_expanded_ = 0;
+bool file_budget::_exhausted_ = false;
+file_budget::clock::time_point file_budget::_start_;
+
+void file_budget::start()
+{
+	_expanded_ = 0;
+	_exhausted_ = false;
+	_start_ = clock::now();
+}
+
+bool file_budget::check()
+{
+	if (_exhausted_) {
+		return true;
+	}
+	if (_expansions_ && _expanded_ > _expansions_) {
+		_exhausted_ = true;
+		warning_budget_exhausted() << "Evaluation abandoned for the rest "
+			"of the file: more than " << _expansions_ <<
+			" macro-expansions. Directives will be left unresolved" << emit();
+	} else if (_millisecs_ &&
+			clock::now() - _start_ > chrono::milliseconds(_millisecs_)) {
+		_exhausted_ = true;
+		warning_budget_exhausted() << "Evaluation abandoned for the rest "
+			"of the file: more than " << _millisecs_ <<
+			" ms spent. Directives will be left unresolved" << emit();
+	}
+	return _exhausted_;
+}
+
+// EOF
@@ -0,0 +1,132 @@
+#ifndef FILE_BUDGET_H
+#define FILE_BUDGET_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include <chrono>
+
+/** \file file_budget.h
+ *   This file defines `struct file_budget`
+ */
+
+/** \brief `struct file_budget` limits the effort spent on evaluating
+ *	the directives of a single input file.
+ *
+ *  With the `--file-budget-ms` option, a file may be processed for at most
+ *	a given number of milliseconds. With the `--expansion-budget` option,
+ *	a file may incur at most a given number of macro-expansions.
+ *	When a file exceeds a budget, the rest of its conditional directives
+ *	are left unresolved, just as if they depended on insoluble
+ *	references, and are output unchanged.
+ *
+ *	The budget is checked before each conditional directive is evaluated
+ *	and whenever a macro-expansion, top-level or nested, is charged, so
+ *	that a single explosive `#if` is abandoned as soon as it overruns.
+ */
+struct file_budget {
+
+	/// Get a reference to the time budget for a file, in milliseconds.
+	static unsigned & millisecs() {
+		return _millisecs_;
+	}
+
+	/// Get a reference to the macro-expansion budget for a file.
+	static unsigned long & expansions() {
+		return _expansions_;
+	}
+
+	/// Start the budgets for a new file.
+	static void top() {
+		if (_millisecs_ || _expansions_) {
+			start();
+		}
+	}
+
+	/// Type of exception thrown when a charge overruns a budget.
+	struct overrun {};
+
+	/** \brief Charge a macro-expansion to the current file.
+	 *
+	 *	The expansion is charged before it is performed.
+	 *
+	 *	\throw overrun if the file has now exceeded a budget.
+	 */
+	static void charge_expansion() {
+		++_expanded_;
+		if (exhausted()) {
+			throw overrun();
+		}
+	}
+
+	/** \brief Say whether the current file has exceeded a budget.
+	 *
+	 *	The first time the file is found to exceed a budget, a warning
+	 *	is issued.
+	 */
+	static bool exhausted() {
+		return (_millisecs_ || _expansions_) && check();
+	}
+
+	/** \brief Say whether the current file has been found to exceed a
+	 *	budget, without checking again.
+	 */
+	static bool abandoned() {
+		return _exhausted_;
+	}
+
+private:
+
+	/// Type of clock that times files
+	using clock = std::chrono::steady_clock;
+
+	/// Start the budgets for a new file
+	static void start();
+
+	/// Check whether a budget is exceeded
+	static bool check();
+
+	/// The time budget in milliseconds, if any.
+	static unsigned _millisecs_;
+	/// The macro-expansion budget, if any.
+	static unsigned long _expansions_;
+	/// The number of macro-expansions incurred by the current file.
+	static unsigned long _expanded_;
+	/// Has the current file exceeded a budget?
+	static bool _exhausted_;
+	/// The time at which processing of the current file began.
+	static clock::time_point _start_;
+};
+
+#endif // EOF
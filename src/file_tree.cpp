@@ -160,6 +160,10 @@ unsigned file_tree::node::terminal_insert(path_t & abs_path, Filter & filter)
         } else if (fs::is_file(obj_type)) {
             new_files += filter(abs_path.str());
         } else if (fs::is_dir(obj_type)) {
+            if (!filter.admits_dir(abs_path.str())) {
+                /* The directory is pruned unread */
+                return new_files;
+            }
             directory dir(abs_path.str());
             for (std::string entry;
                  dir && (!(entry = dir.next()).empty()); ) {
@@ -325,6 +325,10 @@ public:
 		bool operator ()(std::string const &) const {
 			return true;
 		}
+		/// The null filter admits every directory.
+		bool admits_dir(std::string const &) const {
+			return true;
+		}
 	};
 
 	/// Default constructor
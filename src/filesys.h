@@ -170,6 +170,40 @@ extern permissions get_permissions(std::string const & filename);
  */
 extern int set_permissions(std::string const & filename, permissions p);
 
+/** \brief Get the size of a file.
+ *
+ *   \param filename The file to query.
+ *   \return The size in bytes of `filename`, or 0 if it is not a
+ *   readable file.
+ */
+extern unsigned long long file_size(std::string const & filename);
+
+/** \brief Get the time at which a file was last modified.
+ *
+ *   \param filename The file to query.
+ *   \return The modification time of `filename` in nanoseconds since
+ *   an epoch that is fixed for the host, or 0 if it is not a readable file.
+ */
+extern unsigned long long modified_time(std::string const & filename);
+
+/** \brief Map the contents of a file into memory for reading.
+ *
+ *   \param filename The file to map.
+ *   \param size On return, the size in bytes of the mapped contents.
+ *   \return A pointer to the read-only contents of `filename`, or
+ *   `nullptr` if the file cannot be mapped. An empty file is not mapped.
+ *
+ *   A mapping that is obtained must be released with `unmap_file`.
+ */
+extern char const * map_file(std::string const & filename, size_t & size);
+
+/** \brief Release a mapping obtained from `map_file`.
+ *
+ *   \param data The pointer returned by `map_file`.
+ *   \param size The size returned by `map_file`.
+ */
+extern void unmap_file(char const * data, size_t size);
+
 } // namespace fs
 
 #endif // EOF
@@ -46,7 +46,7 @@ void formal_parameter_list::read(chewer<CharSeq> & chew)
 {
 	_defect = formal_parameter_list::none;
 	if (*chew == '(') {
-		unique_ptr<vector<string>> params(new vector<string>);
+		params_type params;
 		chew(+1,greyspace);
 		string param;
 		for ( ; chew; chew(+1,greyspace)) {
@@ -78,39 +78,40 @@ void formal_parameter_list::read(chewer<CharSeq> & chew)
 					_defect = formal_parameter_list::non_param;
 				}
 				else {
-					params->push_back(param);
 					if (param.empty()) {
 						_defect = formal_parameter_list::empty_param;
-					} else {
-						param.clear();
 					}
+					params.push_back(std::move(param));
+					param.clear();
 				}
 			} else if (*chew == ')') {
 				if (param.empty()) {
-					if (params->size()) {
+					if (params.size()) {
 						_defect = formal_parameter_list::empty_param;
 					}
 				} else {
-					params->push_back(param);
+					params.push_back(std::move(param));
 					param.clear();
 				}
 				break;
 			}
 		}
 		if (!param.empty()) {
-			params->push_back(param);
+			params.push_back(std::move(param));
 		}
 		if (!chew || *chew != ')') {
 			_defect = formal_parameter_list::unclosed;
 		} else {
 			++chew;
 		}
-		if (params->size()) {
-			_params.reset(params.release());
+		if (params.size()) {
+			_params = std::move(params);
+			_null = false;
 		}
 		return;
 	}
-	_params.reset();
+	_params.clear();
+	_null = true;
 }
 
 template
@@ -48,6 +48,8 @@
 #include "path.h"
 #include <cstring>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <climits>
 #include <cerrno>
@@ -141,6 +143,55 @@ int set_permissions(std::string const & filename, permissions p)
 	return chmod(filename.c_str(),p & 0777);
 }
 
+unsigned long long file_size(std::string const & filename)
+{
+	struct stat obj_info;
+	if (stat(filename.c_str(),&obj_info) || !S_ISREG(obj_info.st_mode)) {
+		return 0;
+	}
+	return (unsigned long long)obj_info.st_size;
+}
+
+unsigned long long modified_time(std::string const & filename)
+{
+	struct stat obj_info;
+	if (stat(filename.c_str(),&obj_info) || !S_ISREG(obj_info.st_mode)) {
+		return 0;
+	}
+	return (unsigned long long)obj_info.st_mtim.tv_sec * 1000000000 +
+		obj_info.st_mtim.tv_nsec;
+}
+
+char const * map_file(std::string const & filename, size_t & size)
+{
+	size = 0;
+	int fd = ::open(filename.c_str(),O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	void * data = MAP_FAILED;
+	struct stat obj_info;
+	if (!fstat(fd,&obj_info) && S_ISREG(obj_info.st_mode) &&
+			obj_info.st_size > 0) {
+		size = size_t(obj_info.st_size);
+		data = mmap(nullptr,size,PROT_READ,MAP_PRIVATE,fd,0);
+	}
+	::close(fd);
+	if (data == MAP_FAILED) {
+		size = 0;
+		return nullptr;
+	}
+	madvise(data,size,MADV_SEQUENTIAL);
+	return static_cast<char const *>(data);
+}
+
+void unmap_file(char const * data, size_t size)
+{
+	if (data) {
+		munmap(const_cast<char *>(data),size);
+	}
+}
+
 } // namespace fs
 
 #endif
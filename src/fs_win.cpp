@@ -45,6 +45,7 @@
 #include "diagnostic.h"
 #include "path.h"
 #include <cassert>
+#include <cstdio>
 #include <ctype.h>
 #include <stdlib.h>
 #include <windows.h>
@@ -121,6 +122,59 @@ int set_permissions(std::string const & filename, permissions p)
 	return 0;
 }
 
+unsigned long long file_size(std::string const & filename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA obj_info;
+	int res = GetFileAttributesEx(filename.c_str(),GetFileExInfoStandard,
+		&obj_info);
+	if (!res || (obj_info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+		return 0;
+	}
+	return (unsigned long long)obj_info.nFileSizeHigh << 32 |
+		obj_info.nFileSizeLow;
+}
+
+unsigned long long modified_time(std::string const & filename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA obj_info;
+	int res = GetFileAttributesEx(filename.c_str(),GetFileExInfoStandard,
+		&obj_info);
+	if (!res || (obj_info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+		return 0;
+	}
+	/* FILETIME counts 100-nanosecond intervals */
+	return ((unsigned long long)obj_info.ftLastWriteTime.dwHighDateTime << 32 |
+		obj_info.ftLastWriteTime.dwLowDateTime) * 100;
+}
+
+char const * map_file(std::string const & filename, size_t & size)
+{
+	size = 0;
+	FILE * fp = fopen(filename.c_str(),"rb");
+	if (!fp) {
+		return nullptr;
+	}
+	char * data = nullptr;
+	if (!fseek(fp,0,SEEK_END)) {
+		long len = ftell(fp);
+		if (len > 0 && !fseek(fp,0,SEEK_SET)) {
+			data = new char[len];
+			if (fread(data,1,len,fp) == size_t(len)) {
+				size = size_t(len);
+			} else {
+				delete [] data, data = nullptr;
+			}
+		}
+	}
+	fclose(fp);
+	return data;
+}
+
+void unmap_file(char const * data, size_t)
+{
+	delete [] data;
+}
+
 } // namespace fs
 #endif
 
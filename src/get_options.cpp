@@ -167,16 +167,23 @@ getopt_long(int argc, char * argv[], const char *optstr,
 			} else {
 				optlen = strlen(opt);
 			}
-			/* Test for exactly one match of the option*/
+			/* Test for an exact match or exactly one abbreviated match
+				of the option*/
+			bool ambiguous = false;
 			for (i = 0; longopts[i].name != nullptr; ++i) {
 				if (!strncmp(opt,longopts[i].name,optlen)) {
-					if (match != -1) {
-						match = -1;
+					if (longopts[i].name[optlen] == '\0') {
+						match = i;
+						ambiguous = false;
 						break;
 					}
+					ambiguous = match != -1;
 					match = i;
 				}
 			}
+			if (ambiguous) {
+				match = -1;
+			}
 			if (longind != nullptr) {
 				*longind = match;
 			}
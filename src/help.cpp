@@ -90,6 +90,14 @@ string usage()
 	        "parsing in the manner of the C preprocessor. "
 	        "(Directives are #includes, #defines, #undefs, "
 	        "#pragmas, #errors, #lines).\n"
+	        "11. " + options::prog_name() + " merge OPTION... REPORT...\n"
+	        "\tCombine the REPORTs written by a listing command run with "
+	        "--shard 1/N,...,--shard N/N, given in that order, as a single "
+	        "run of the command would have written them.\n"
+	        "12. " + options::prog_name() + " precompile-config OPTION... "
+	        "CFGFILE\n"
+	        "\tDigest the -D and -U OPTIONs and save the resulting "
+	        "configuration in CFGFILE, to be restored with --config.\n"
 
 	        "General OPTIONS:\n"
 	        "\t-fARGFILE, --file ARGFILE\n"
@@ -100,6 +108,13 @@ string usage()
 	        "\t--filter EXT1[,EXT2...]\n"
 	        "\t\tProcess only input files that have one of the file extensions "
 	        "EXT1,EXT2...\n"
+	        "\t--exclude GLOB\n"
+	        "\t\tDo not process input files that match GLOB.\n"
+	        "\t--exclude-dir GLOB\n"
+	        "\t\tDo not look for input files beneath directories that match "
+	        "GLOB.\n"
+	        "\t\tA GLOB without '/' is matched against the last element of "
+	        "a path. Either option may be repeated.\n"
 	        "\t-DSYM[=VAL], --define SYM[=VAL]\n"
 	        "\t\tAssume symbol SYM to be defined [=VAL]\n"
 	        "\t-USYM, --undef SYM\n"
@@ -130,9 +145,75 @@ string usage()
 	        "\t-E, --eval-wip\n"
 	        "\t\tEvaluate constants in the \"work-in-progress\" directives "
 			"\"#if 0\",\"#if 1\". (Default: do not evaluate.)\n"
-			"\t--max-expansion N[K]\n"
-			"\t\tLimit the length of reported macro-expansions "
-			"to N[kilobytes]\n"
+			"\t--max-expansion N[K|M]\n"
+			"\t\tLimit the size of macro-expansions to N bytes "
+			"[kilobytes|megabytes].\n"
+			"\t\tAn expansion that would exceed the limit is abandoned.\n"
+			"\t\t(Default 4196 bytes)\n"
+			"\t--stats\n"
+			"\t\tAt exit, write a summary of the run to stderr: the time "
+			"spent in each phase of processing, counts of lines, directives "
+			"and resolved #ifs, reference cache hits, symbol table sizes "
+			"and peak memory.\n"
+			"\t--trace FILE\n"
+			"\t\tWrite a timeline of the run to FILE in Chrome trace-event "
+			"format, for viewing in chrome://tracing or Perfetto. It shows "
+			"the processing of each file, the opening and closing of files, "
+			"slow directive evaluations and macro expansions.\n"
+			"\t--trace-threshold USECS\n"
+			"\t\tWith --trace, show only directive evaluations that take "
+			"at least USECS microseconds. (Default 100)\n"
+			"\t--profile-symbols N\n"
+			"\t\tAt exit, write to stderr the N symbols that cost most time "
+			"to evaluate, with the time spent digesting their references, "
+			"the number and largest size of their macro-expansions and the "
+			"number of times they were invalidated.\n"
+			"\t--profile-files N\n"
+			"\t\tAt exit, write to stderr the N input files that took longest "
+			"to process, with the numbers of lines, directives and "
+			"macro-expansions read from each and the bytes output for it.\n"
+			"\t--profile-files-csv CSVFILE\n"
+			"\t\tAt exit, write the same record of every input file "
+			"to CSVFILE.\n"
+			"\t--file-budget-ms MS\n"
+			"\t\tIf an input file takes more than MS milliseconds to "
+			"process, leave its remaining #if directives unresolved.\n"
+			"\t--expansion-budget N\n"
+			"\t\tIf an input file incurs more than N macro-expansions, "
+			"nested ones included, leave its remaining #if directives "
+			"unresolved.\n"
+			"\t--progress\n"
+			"\t\tEvery 5 seconds, write to stderr the number of files done, "
+			"the files, lines and megabytes processed per second and the "
+			"estimated time to completion. (On Unix-like hosts, the --stats "
+			"summary is written to stderr on receipt of SIGUSR1.)\n"
+			"\t--progress-interval SECS\n"
+			"\t\tReport progress every SECS seconds. Implies --progress.\n"
+			"\t--shard I/N\n"
+			"\t\tPartition the input files, in the order they are "
+			"processed, into N consecutive shards of about equal size and "
+			"process only the I-th shard. The reports of the N shards can "
+			"be combined with the merge command. Implies --keepgoing.\n"
+			"\t--compile-db FILE\n"
+			"\t\tAdd the source files of the compilation database FILE "
+			"(compile_commands.json) to the input files and process each "
+			"of them under the -D and -U options of the commandline followed "
+			"by the -D and -U options of its compiler arguments. The last "
+			"of these options for a symbol wins and overrides the commandline.\n"
+			"\t--config CFGFILE\n"
+			"\t\tRestore the configuration saved in CFGFILE by the "
+			"precompile-config command, as if its -D and -U options were "
+			"given here. Must precede any -D or -U option. CFGFILE is only "
+			"valid for the version of the program that wrote it.\n"
+			"\t--expansion-cache FILE\n"
+			"\t\tKeep in FILE the macro-expansions of references of "
+			"--define-ed symbols that depend only on the -D and -U options, "
+			"and recall them in later runs with the same options instead of "
+			"expanding them again.\n"
+			"\t--config-header HEADER\n"
+			"\t\tDigest each #define and #undef directive in HEADER as the "
+			"equivalent -D or -U option, in order. Other directives are "
+			"ignored.\n"
 
 	        "source OPTIONs:-\n"
 	        "\t-r, --replace\n"
@@ -140,6 +221,9 @@ string usage()
 	        "\t\tWith -r, stdin supplies the input *filenames*.\n"
 	        "\t\tOtherwise stdin supplies an input *file*; "
 	        "the output file is cout.\n"
+	        "\t-0, --null\n"
+	        "\t\tThe input filenames on stdin are delimited by NUL, as "
+	        "written by find -print0, and may contain whitespace.\n"
 	        "\t-bSUFFIX, --backup SUFFIX\n"
 	        "\t\tBackup each input file by appending SUFFIX to the name.\n"
 	        "\t\tApplies only with -r.\n"
@@ -199,6 +283,12 @@ string usage()
 	        "\t\tIn organizing output files beneath the directory DIRNAME, "
 	        "DIRNAME will be equated to the path prefix PATHNAME of any "
 	        "input file.\n"
+	        "\t--index FILE\n"
+	        "\t\tRecord in FILE the symbols on which each input file depends. "
+	        "A later spin with the same FILE skips, without reading, the files "
+	        "that are unchanged and do not depend on any symbol whose -D or -U "
+	        "option has changed. A change of any other option that affects "
+	        "the output spins every file. Not valid with --compile-db.\n"
 
 	        "symbols OPTIONs:-\n"
 	        "\t-i, --ifs\n"
@@ -323,7 +413,15 @@ string usage()
 	        "\t\tList only inoperative directives.\n"
 	        "\t-L, --locate\n"
 	        "\t\tReport the source file and line number of each listed "
-	        "occurrence.";
+	        "occurrence.\n"
+
+	        "merge OPTIONs:-\n"
+	        "\t-o, --once-only\n"
+	        "\t-L, --locate\n"
+	        "\t\tAs given to the listing command that wrote the REPORTs.\n"
+	        "\t--exit-codes RC1[,RC2...]\n"
+	        "\t\tThe exit codes of the shard runs, to be combined in the "
+	        "exit code of the merge.";
 }
 
 // EOF
@@ -41,8 +41,12 @@
 #include "directive.h"
 #include "diagnostic.h"
 #include "symbol.h"
+#include "stats.h"
+#include "trace.h"
 #include <fstream>
 #include <iostream>
+#include <cstdio>
+#include <cstring>
 
 /** \file io.cpp
  *   This file implements `struct io`
@@ -56,15 +60,79 @@ fs::permissions io::_in_out_permissions_(-1);
 filebuf io::_outfile_;
 istream * io::_input_(nullptr);
 filebuf io::_infile_;
+char const * io::_input_map_(nullptr);
+size_t io::_input_map_size_(0);
 string io::_out_filename_;
 string io::_bak_filename_;
 char const * const io::_stdin_name_ = "[stdin]";
 string io::_spin_dir_;
 string io::_spin_prefix_;
+string io::_partial_filename_;
+
+/// \cond NO_DOXYGEN
+
+/// A `streambuf` that counts the bytes it passes to another
+struct counting_buf : streambuf
+{
+	/// Get the number of bytes passed so far
+	unsigned long long count() const {
+		return _count;
+	}
+
+	/// Pass output to a given `streambuf` from now on
+	streambuf * attach(streambuf * sink) {
+		_sink = sink;
+		return this;
+	}
+
+protected:
+
+	streamsize xsputn(char const * s, streamsize n) override {
+		n = _sink->sputn(s,n);
+		_count += n;
+		return n;
+	}
+
+	int_type overflow(int_type ch) override {
+		if (traits_type::eq_int_type(ch,traits_type::eof())) {
+			return traits_type::not_eof(ch);
+		}
+		ch = _sink->sputc(traits_type::to_char_type(ch));
+		_count += !traits_type::eq_int_type(ch,traits_type::eof());
+		return ch;
+	}
+
+	int sync() override {
+		return _sink->pubsync();
+	}
+
+private:
+
+	streambuf * _sink = nullptr;
+	unsigned long long _count = 0;
+};
+
+/// \endcond NO_DOXYGEN
+
+/// Counts the output when `io::count_output()` has been called
+static counting_buf output_counter;
+/// Is the output being counted?
+static bool counting_output = false;
+
+void io::count_output()
+{
+	counting_output = true;
+}
+
+unsigned long long io::bytes_written()
+{
+	return output_counter.count();
+}
 
 void io::top() {
 	line_despatch::top();
 	_in_filename_.resize(0);
+	_partial_filename_.resize(0);
 }
 
 void io::delete_infile()
@@ -109,6 +177,34 @@ string io::read_filename()
 	return filename;
 }
 
+bool io::read_filenames(vector<string> & filenames)
+{
+	char block[65536];
+	size_t len = fread(block,1,sizeof(block),stdin);
+	if (len == 0) {
+		if (_partial_filename_.empty()) {
+			return false;
+		}
+		/* The last filename need not be terminated */
+		filenames.push_back(_partial_filename_);
+		_partial_filename_.clear();
+		return true;
+	}
+	char const * pos = block;
+	char const * const end = block + len;
+	for (char const * nul;
+			(nul = static_cast<char const *>(memchr(pos,0,end - pos))) !=
+				nullptr; pos = nul + 1) {
+		_partial_filename_.append(pos,nul);
+		if (!_partial_filename_.empty()) {
+			filenames.push_back(_partial_filename_);
+			_partial_filename_.clear();
+		}
+	}
+	_partial_filename_.append(pos,end);
+	return true;
+}
+
 void io::make_tempfile()
 {
 	path_t path(fs::real_path(_in_filename_));
@@ -159,7 +255,8 @@ void io::open_outfile()
 		abend_cant_open_output() << "Can't open " <<
 			 _out_filename_ << " for writing" << emit();
 	}
-	_output_ = new ostream(&_outfile_);
+	_output_ = new ostream(counting_output ?
+		output_counter.attach(&_outfile_) : &_outfile_);
 }
 
 void io::open_output()
@@ -172,16 +269,25 @@ void io::open_output()
 		make_tempfile();
 		open_outfile();
 	} else {
-		_output_ = new ostream(cout.rdbuf());
+		_output_ = new ostream(counting_output ?
+			output_counter.attach(cout.rdbuf()) : cout.rdbuf());
 	}
 }
 
 void io::close(unsigned error)
 {
+	stats::timer timing(stats::phase::output);
+	trace::span tracing("io");
+	if (tracing) {
+		tracing.name("io::close");
+		tracing.arg("file",_in_filename_);
+	}
 	delete _input_, _input_ = nullptr;
 	delete _output_, _output_ = nullptr;
 	_infile_.close();
 	_outfile_.close();
+	fs::unmap_file(_input_map_,_input_map_size_);
+	_input_map_ = nullptr, _input_map_size_ = 0;
 	if (!error) {
 		if (options::replace() && !spin()) {
 			if (options::backup_suffix().length()) {
@@ -201,18 +307,28 @@ void io::close(unsigned error)
 
 void io::open(string const & fname)
 {
+	trace::span tracing("io");
+	if (tracing) {
+		tracing.name("io::open");
+		tracing.arg("file",fname);
+	}
 	_in_filename_ = fname;
-	delete _input_;
+	delete _input_, _input_ = nullptr;
 	if (fname != _stdin_name_) {
 		_in_out_permissions_ =
 			options::replace() ? fs::get_permissions(fname) : -1;
-		_infile_.open(fname.c_str(),ios_base::in);
-		if (!_infile_.is_open()) {
-			abend_cant_open_input() << "Can't open " <<
-				_in_filename_ << " for reading" << emit();
+		if (options::directives_only()) {
+			_input_map_ = fs::map_file(fname,_input_map_size_);
+		}
+		if (!_input_map_) {
+			_infile_.open(fname.c_str(),ios_base::in);
+			if (!_infile_.is_open()) {
+				abend_cant_open_input() << "Can't open " <<
+					_in_filename_ << " for reading" << emit();
+			}
+			_input_ = new istream(&_infile_);
+			assert(_input_->good());
 		}
-		_input_ = new istream(&_infile_);
-		assert(_input_->good());
 	} else {
 		_input_ = new istream(cin.rdbuf());
 	}
@@ -234,17 +350,23 @@ void io::set_spin_prefix(char const *optarg)
 	_spin_prefix_ = fs::real_path(optarg);
 }
 
-void io::make_spinfile()
+string io::spin_filename(string const & in_filename)
 {
 	path_t spin_filename(_spin_dir_);
-	path_t in_filename(_in_filename_);
-	assert(fs::is_absolute(_in_filename_));
+	path_t in_path(in_filename);
+	assert(fs::is_absolute(in_filename));
 	if (_spin_prefix_.empty()) {
-		spin_filename += in_filename.segment(1);
+		spin_filename += in_path.segment(1);
 	} else {
 		static path_t prefix(_spin_prefix_);
-		spin_filename += in_filename.segment(prefix.elements());
+		spin_filename += in_path.segment(prefix.elements());
 	}
+	return spin_filename.str();
+}
+
+void io::make_spinfile()
+{
+	path_t spin_filename(io::spin_filename(_in_filename_));
 	size_t parts = spin_filename.elements();
 	string dir = spin_filename.segment(0,parts - 1);
 	fs::make_dir(dir);
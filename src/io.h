@@ -41,6 +41,7 @@
 
 #include "filesys.h"
 #include <string>
+#include <vector>
 #include <cassert>
 
 /** \file io.h
@@ -64,6 +65,16 @@ struct io {
 	 */
 	static std::string read_filename();
 
+	/** \brief Read a block of NUL-delimited source filenames from `stdin`.
+     *
+	 *  \param filenames Receives the filenames completed by the block.
+	 *  A filename that is cut off by the end of the block is completed
+	 *	by the next call. Empty filenames are skipped.
+     *
+	 *  \return False if `stdin` is exhausted, else true.
+	 */
+	static bool read_filenames(std::vector<std::string> & filenames);
+
 	/** \brief Open a named file for reading or writing.
      *
 	 *  \param file The name of the file to be opened
@@ -111,11 +122,38 @@ struct io {
 		return _output_;
 	}
 
+	/** \brief Count the bytes of output written from now on.
+	 *
+	 *	Output is counted by passing it through a filter, so
+	 *	it is counted only on demand.
+	 */
+	static void count_output();
+
+	/** \brief Get the number of bytes written to the output stream since
+	 *	`count_output()` was called.
+	 */
+	static unsigned long long bytes_written();
+
 	/// Get a pointer to the input stream.
 	static std::istream * input() {
 		return _input_;
 	}
 
+	/** \brief Get a pointer to the memory-mapped contents of the current
+	 *	source file, if it is mapped, else `nullptr`.
+	 *
+	 *	The source file is mapped only when `options::directives_only()`
+	 *	and it is not the standard input.
+	 */
+	static char const * input_map() {
+		return _input_map_;
+	}
+
+	/// Get the size of the memory-mapped contents of the current source file.
+	static size_t input_map_size() {
+		return _input_map_size_;
+	}
+
 	/** \brief Set the directory in which to output a spin.
 	 *	\param	optarg	The commandline option specifing the spin directory
 	 *		name.
@@ -141,6 +179,12 @@ struct io {
 		return !_spin_dir_.empty();
 	}
 
+	/** \brief Get the name of the file in the spin directory that
+	 *	corresponds to an input file.
+	 *	\param in_filename The absolute name of an input file.
+	 */
+	static std::string spin_filename(std::string const & in_filename);
+
 private:
 
 	/**	\brief Replace the current input source file with the temporary output
@@ -223,6 +267,10 @@ private:
 	static std::istream * _input_;
 	/// The input file
 	static std::filebuf _infile_;
+	/// The memory-mapped contents of the input file, if mapped
+	static char const * _input_map_;
+	/// The size of the memory-mapped contents of the input file
+	static size_t _input_map_size_;
 	/// File permissions mask of input file, in case file is replaced
 	static fs::permissions _in_out_permissions_;
 	///  Current output filename, if needed
@@ -235,6 +283,10 @@ private:
 	static std::string _spin_dir_;
 	/// Path prefix assumed to match the spin directory
 	static std::string _spin_prefix_;
+	/** \brief The start of a NUL-delimited filename cut off by the end of
+	 *	the last block read by `read_filenames()`
+	 */
+	static std::string _partial_filename_;
 };
 
 #endif /* EOF*/
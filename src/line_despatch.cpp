@@ -48,6 +48,7 @@
 #include "if_control.h"
 #include "canonical.h"
 #include "directive.h"
+#include "stats.h"
 
 /** \file line_despatch.cpp
  *  This file implements `struct line_despatch`
@@ -60,7 +61,13 @@ std::unique_ptr<parsed_line> line_despatch::_cur_line_(nullptr);
 
 void line_despatch::top()
 {
-	_cur_line_.reset(new parsed_line(io::input(),io::output()));
+	if (io::input_map()) {
+		char const * map = io::input_map();
+		_cur_line_.reset(new parsed_line(
+			map,map + io::input_map_size(),io::output()));
+	} else {
+		_cur_line_.reset(new parsed_line(io::input(),io::output()));
+	}
 }
 
 void line_despatch::substitute(string const & replacement)
@@ -79,6 +86,7 @@ line_type line_despatch::next()
 		if_control::transition(LT_EOF);
 		return LT_EOF;
 	}
+	stats::count_lines();
 	chewer<parse_buffer> chew(!options::plaintext(),*_cur_line_);
 	line_type retval = LT_PLAIN;
 	chew(greyspace);
@@ -89,10 +97,7 @@ line_type line_despatch::next()
 	}
 	_cur_line_->indent() = size_t(chew);
 	chew(+1,greyspace);
-	size_t keyword_off = size_t(chew);
-	string keyword = canonical<symbol>(chew);
-	cur_line().mark_keyword(keyword_off,keyword.length());
-	retval = directive_base::eval(keyword,chew);
+	retval = directive_base::eval(chew);
 	if (retval == LT_DIRECTIVE_KEEP) {
 		/* A non-if directive is the same as a non-directive for if-control */
 		retval = LT_PLAIN;
@@ -41,6 +41,9 @@
 #include "help.h"
 #include "dataset.h"
 #include "diagnostic.h"
+#include "progress_meter.h"
+#include "report_merge.h"
+#include "config_snapshot.h"
 #include <iostream>
 
 using namespace std;
@@ -75,10 +78,17 @@ int main(int argc, char *argv[])
 static void
 process()
 {
-	if (dataset::files() == 0) {
-		dataset::add(io::_stdin_name_);
+	if (options::get_command() == CMD_MERGE) {
+		report_merge::merge();
+	} else if (options::get_command() == CMD_PRECOMPILE) {
+		config_snapshot::save();
+	} else {
+		if (dataset::files() == 0) {
+			dataset::add(io::_stdin_name_);
+		}
+		progress_meter::arm();
+		dataset::traverse();
 	}
-	dataset::traverse();
 	exit(diagnostic_base::exitcode());
 }
 
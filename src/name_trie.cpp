@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "name_trie.h"
+#include <algorithm>
+
+/** \file name_trie.cpp
+ *   This file implements `struct name_trie`
+ */
+
+using namespace std;
+
+namespace {
+
+/// Order a successor and a character by the character.
+bool before(pair<char,unsigned> const & child, char c)
+{
+	return child.first < c;
+}
+
+} // namespace
+
+bool name_trie::add(string const & pattern)
+{
+	bool wildcard =
+		!pattern.empty() && pattern[pattern.length() - 1] == '*';
+	size_t len = pattern.length() - wildcard;
+	unsigned n = 0;
+	for (size_t i = 0; i < len; ++i) {
+		char c = pattern[i];
+		auto & children = _nodes[n]._children;
+		auto where = lower_bound(children.begin(),children.end(),c,before);
+		if (where != children.end() && where->first == c) {
+			n = where->second;
+		} else {
+			unsigned next = unsigned(_nodes.size());
+			children.insert(where,make_pair(c,next));
+			/* `children` is invalidated by growing `_nodes` */
+			_nodes.emplace_back();
+			n = next;
+		}
+	}
+	bool & mark = wildcard ? _nodes[n]._prefix : _nodes[n]._name;
+	bool added = !mark;
+	mark = true;
+	return added;
+}
+
+bool name_trie::matches(string const & name) const
+{
+	unsigned n = 0;
+	for (char c : name) {
+		if (_nodes[n]._prefix) {
+			return true;
+		}
+		n = child(n,c);
+		if (!n) {
+			return false;
+		}
+	}
+	return _nodes[n]._name || _nodes[n]._prefix;
+}
+
+unsigned name_trie::child(unsigned n, char c) const
+{
+	auto const & children = _nodes[n]._children;
+	auto where = lower_bound(children.begin(),children.end(),c,before);
+	return where != children.end() && where->first == c ? where->second : 0;
+}
+
+// EOF
@@ -0,0 +1,96 @@
+#ifndef NAME_TRIE_H
+#define NAME_TRIE_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+#include <utility>
+
+/** \file name_trie.h
+ *   This file defines `struct name_trie`
+ */
+
+/** \brief `struct name_trie` is a prefix trie of names and `*`-terminated
+ *	wildcard patterns, against which a name is matched in one pass over
+ *	its characters.
+ *
+ *	A pattern that ends with `*` matches any name that begins with the
+ *	preceding portion of the pattern. Any other pattern matches only
+ *	the name that is identical with it.
+ */
+struct name_trie {
+
+	name_trie()
+	: _nodes(1){}
+
+	/** \brief Add a pattern.
+	 *	\param pattern The name or wildcard pattern to add.
+	 *	\return True if the pattern was added, false if it was
+	 *		already present.
+	 */
+	bool add(std::string const & pattern);
+
+	/// Say whether a name matches any of the patterns.
+	bool matches(std::string const & name) const;
+
+	/// Say whether there are no patterns.
+	bool empty() const {
+		return _nodes.size() == 1 && !_nodes[0]._name && !_nodes[0]._prefix;
+	}
+
+private:
+
+	/// A node of the trie, representing the prefix that leads to it.
+	struct node {
+		/// The successor nodes, in ascending order of their characters.
+		std::vector<std::pair<char,unsigned>> _children;
+		/// Is the prefix a pattern for the identical name?
+		bool _name = false;
+		/// Is the prefix a pattern for every name it begins?
+		bool _prefix = false;
+	};
+
+	/** \brief Get the successor of a node for a character.
+	 *	\param n The index of the node.
+	 *	\param c The character.
+	 *	\return The index of the successor, or 0 if there is none.
+	 */
+	unsigned child(unsigned n, char c) const;
+
+	/// The nodes of the trie, the root first.
+	std::vector<node> _nodes;
+};
+
+#endif // EOF
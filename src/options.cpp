@@ -50,9 +50,24 @@
 #include "line_despatch.h"
 #include "help.h"
 #include "version.h"
+#include "trace.h"
+#include "profile.h"
+#include "file_budget.h"
+#include "progress_meter.h"
+#include "shard.h"
+#include "report_merge.h"
+#include "symbol_index.h"
+#include "compile_db.h"
+#include "config_header.h"
+#include "exclude_rules.h"
+#include "config_snapshot.h"
+#include "expansion_cache.h"
+#include "stats.h"
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <set>
+#include <climits>
 
 using namespace std;
 
@@ -63,6 +78,7 @@ string options::_backup_suffix_;
 string 	options::_memfile_;
 bool	options::_got_opts_ = false;
 bool	options::_replace_ = false;
+bool	options::_null_delimited_ = false;
 bool	options::_list_locate_ = false;
 bool	options::_list_only_once_ = false;
 bool 	options::_list_once_per_file_ = false;
@@ -91,13 +107,17 @@ bool	options::_implicit_ = false;
 bool	options::_no_transients_ = false;
 int		options::_diagnostic_filter_ = 0;
 bool    options::_parsing_file_ = false;
+bool    options::_parsing_config_ = false;
+vector<string> options::_config_args_;
 vector<string> options::_argfile_argv_;
 int		options::_cmd_line_files_ = 0;
-unsigned options::_max_expansion_ = 4096;
+unsigned options::_max_expansion_ = 4196;
+bool	options::_stats_ = false;
 
 struct option options::long_options [] = {
 	{ "file", required_argument, nullptr, OPT_FILE },
 	{ "replace",no_argument, nullptr, OPT_REPLACE },
+	{ "null", no_argument, nullptr, OPT_NULL },
 	{ "backup",required_argument,nullptr,OPT_BACKUP},
 	{ "define", required_argument, nullptr, OPT_DEF },
 	{ "undef", required_argument, nullptr, OPT_UNDEF },
@@ -111,6 +131,8 @@ struct option options::long_options [] = {
 	{ "pod", no_argument, nullptr, OPT_POD },
 	{ "recurse", no_argument, nullptr, OPT_RECURSE },
 	{ "filter", required_argument, nullptr, OPT_FILTER },
+	{ "exclude", required_argument, nullptr, OPT_EXCLUDE },
+	{ "exclude-dir", required_argument, nullptr, OPT_EXCLUDE_DIR },
 	{ "keepgoing", no_argument, nullptr, OPT_KEEPGOING },
 	{ "ifs", no_argument, nullptr, OPT_IFS },
 	{ "defs", no_argument, nullptr, OPT_DEFS },
@@ -132,6 +154,23 @@ struct option options::long_options [] = {
 	{ "prefix", required_argument, nullptr, OPT_PREFIX },
 	{ "select", required_argument, nullptr, OPT_SELECT },
 	{ "max-expansion", required_argument, nullptr, OPT_EXPAND_MAX },
+	{ "stats", no_argument, nullptr, OPT_STATS },
+	{ "trace", required_argument, nullptr, OPT_TRACE },
+	{ "trace-threshold", required_argument, nullptr, OPT_TRACE_THRESHOLD },
+	{ "profile-symbols", required_argument, nullptr, OPT_PROFILE_SYMBOLS },
+	{ "profile-files", required_argument, nullptr, OPT_PROFILE_FILES },
+	{ "profile-files-csv", required_argument, nullptr, OPT_PROFILE_FILES_CSV },
+	{ "file-budget-ms", required_argument, nullptr, OPT_FILE_BUDGET_MS },
+	{ "expansion-budget", required_argument, nullptr, OPT_EXPANSION_BUDGET },
+	{ "progress", no_argument, nullptr, OPT_PROGRESS },
+	{ "progress-interval", required_argument, nullptr, OPT_PROGRESS_INTERVAL },
+	{ "shard", required_argument, nullptr, OPT_SHARD },
+	{ "exit-codes", required_argument, nullptr, OPT_EXIT_CODES },
+	{ "index", required_argument, nullptr, OPT_INDEX },
+	{ "compile-db", required_argument, nullptr, OPT_COMPILE_DB },
+	{ "config", required_argument, nullptr, OPT_CONFIG },
+	{ "expansion-cache", required_argument, nullptr, OPT_EXPANSION_CACHE },
+	{ "config-header", required_argument, nullptr, OPT_CONFIG_HEADER },
 	{ 0, 0, 0, 0 }
 };
 
@@ -154,6 +193,8 @@ struct cmd_option options::commands [] = {
 	{ "lines", CMD_LINES },
 	{ "directives", CMD_DIRECTIVES },
 	{ "spin", CMD_SPIN },
+	{ "merge", CMD_MERGE },
+	{ "precompile-config", CMD_PRECOMPILE },
 	{ 0, 0 }
 };
 
@@ -161,61 +202,90 @@ int const options::source_cmd_exclusions[] = {
 	OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES, OPT_LOCATE,
 	OPT_ONCE, OPT_SYSTEM, OPT_LOCAL, OPT_ACTIVE, OPT_INACTIVE,
 	OPT_EXPAND, OPT_PREFIX, OPT_EXPLAIN, OPT_SELECT, OPT_LNS,
-	OPT_ONCE_PER_FILE,0
+	OPT_ONCE_PER_FILE, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::symbols_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_SYSTEM,
-	OPT_LOCAL, OPT_BACKUP, OPT_COMPLEMENT, OPT_DIR, OPT_PREFIX, 0
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_SYSTEM,
+	OPT_LOCAL, OPT_BACKUP, OPT_COMPLEMENT, OPT_DIR, OPT_PREFIX,
+	OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::includes_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES, OPT_COMPLEMENT,
 	OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN, OPT_SELECT,
-	OPT_LNS, 0
+	OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::directives_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES, OPT_COMPLEMENT,
 	OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN, OPT_SELECT,
-	OPT_LNS, 0
+	OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::defs_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_SYSTEM, OPT_LOCAL, OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES,
 	OPT_COMPLEMENT, OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN,
-	OPT_SELECT, OPT_LNS, 0
+	OPT_SELECT, OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::pragmas_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_SYSTEM, OPT_LOCAL, OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES,
 	OPT_COMPLEMENT, OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN,
-	OPT_SELECT, OPT_LNS, 0
+	OPT_SELECT, OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::errors_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_SYSTEM, OPT_LOCAL, OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES,
 	OPT_COMPLEMENT, OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN,
-	OPT_SELECT, OPT_LNS, 0
+	OPT_SELECT, OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::lines_cmd_exclusions[] = {
-	OPT_REPLACE, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
+	OPT_REPLACE, OPT_NULL, OPT_CONFLICT, OPT_DISCARD, OPT_LINE, OPT_BACKUP,
 	OPT_SYSTEM, OPT_LOCAL, OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES,
 	OPT_COMPLEMENT, OPT_EXPAND, OPT_DIR, OPT_PREFIX, OPT_EXPLAIN,
-	OPT_SELECT, OPT_LNS, 0
+	OPT_SELECT, OPT_LNS, OPT_EXIT_CODES, OPT_INDEX, 0
 };
 
 int const options::spin_cmd_exclusions[] = {
 	OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES, OPT_LOCATE,
 	OPT_ONCE, OPT_SYSTEM, OPT_LOCAL, OPT_ACTIVE, OPT_INACTIVE,
 	OPT_BACKUP, OPT_EXPAND, OPT_EXPLAIN, OPT_SELECT, OPT_LNS,
-	OPT_ONCE_PER_FILE, 0
+	OPT_ONCE_PER_FILE, OPT_EXIT_CODES, 0
+};
+
+int const options::merge_cmd_exclusions[] = {
+	OPT_REPLACE, OPT_NULL, OPT_BACKUP, OPT_DEF, OPT_UNDEF, OPT_CONFLICT,
+	OPT_COMPLEMENT, OPT_EVALWIP, OPT_DISCARD, OPT_LINE, OPT_POD,
+	OPT_RECURSE, OPT_FILTER, OPT_EXCLUDE, OPT_EXCLUDE_DIR, OPT_KEEPGOING,
+	OPT_IFS, OPT_DEFS, OPT_UNDEFS, OPT_INCLUDES, OPT_SYSTEM, OPT_LOCAL,
+	OPT_ACTIVE, OPT_INACTIVE, OPT_EXPAND, OPT_IMPLICIT, OPT_DIR, OPT_PREFIX,
+	OPT_NO_TRANSIENTS, OPT_EXPLAIN, OPT_SELECT, OPT_LNS, OPT_EXPAND_MAX,
+	OPT_ONCE_PER_FILE, OPT_STATS, OPT_TRACE, OPT_TRACE_THRESHOLD,
+	OPT_PROFILE_SYMBOLS, OPT_PROFILE_FILES, OPT_PROFILE_FILES_CSV,
+	OPT_FILE_BUDGET_MS, OPT_EXPANSION_BUDGET, OPT_PROGRESS,
+	OPT_PROGRESS_INTERVAL, OPT_SHARD, OPT_INDEX,
+	OPT_COMPILE_DB, OPT_CONFIG, OPT_EXPANSION_CACHE, OPT_CONFIG_HEADER, 0
+};
+
+int const options::precompile_cmd_exclusions[] = {
+	OPT_REPLACE, OPT_NULL, OPT_BACKUP, OPT_CONFLICT, OPT_COMPLEMENT,
+	OPT_EVALWIP, OPT_DISCARD, OPT_LINE, OPT_POD, OPT_RECURSE, OPT_FILTER,
+	OPT_EXCLUDE, OPT_EXCLUDE_DIR, OPT_KEEPGOING, OPT_IFS, OPT_DEFS,
+	OPT_UNDEFS, OPT_INCLUDES, OPT_LOCATE, OPT_ONCE, OPT_SYSTEM, OPT_LOCAL,
+	OPT_ACTIVE, OPT_INACTIVE, OPT_EXPAND, OPT_IMPLICIT, OPT_DIR, OPT_PREFIX,
+	OPT_NO_TRANSIENTS, OPT_EXPLAIN, OPT_SELECT, OPT_LNS, OPT_EXPAND_MAX,
+	OPT_ONCE_PER_FILE, OPT_TRACE, OPT_TRACE_THRESHOLD, OPT_PROFILE_SYMBOLS,
+	OPT_PROFILE_FILES, OPT_PROFILE_FILES_CSV, OPT_FILE_BUDGET_MS,
+	OPT_EXPANSION_BUDGET, OPT_PROGRESS, OPT_PROGRESS_INTERVAL,
+	OPT_SHARD, OPT_EXIT_CODES, OPT_INDEX, OPT_COMPILE_DB,
+	OPT_EXPANSION_CACHE, 0
 };
 
 struct exclusion_list const options::cmd_exclusion_lists[] = {
@@ -235,12 +305,18 @@ struct exclusion_list const options::cmd_exclusion_lists[] = {
 	{ 	CMD_DEFS, defs_cmd_exclusions },
 	/* Exclusion list for the pragmas command*/
 	{ 	CMD_PRAGMAS, pragmas_cmd_exclusions },
+	/* Exclusion list for the errors command*/
+	{ 	CMD_ERRORS, errors_cmd_exclusions },
 	/* Exclusion list for the lines command*/
 	{ 	CMD_LINES, lines_cmd_exclusions },
-	/* Exclusion list for the pragmas command*/
-	{ 	CMD_ERRORS, errors_cmd_exclusions },
 	/* Exclusion list for the directives command*/
 	{ 	CMD_DIRECTIVES, directives_cmd_exclusions },
+	/* Exclusion list for the spin command*/
+	{ 	CMD_SPIN, spin_cmd_exclusions },
+	/* Exclusion list for the merge command*/
+	{ 	CMD_MERGE, merge_cmd_exclusions },
+	/* Exclusion list for the precompile-config command*/
+	{ 	CMD_PRECOMPILE, precompile_cmd_exclusions },
 	{ 0, nullptr }
 };
 
@@ -393,6 +469,11 @@ void options::parse_command_args(int argc, char *argv[])
 		                         opt,cmd_exclusion_lists,true)) {
 			error_invalid_opt(_command_,opt);
 		}
+		if (_parsing_config_ && opt != OPT_DEF && opt != OPT_UNDEF) {
+			error_usage() << "Only --define and --undef options are valid "
+				"in a compilation database entry, not \"" << argv[optind - 1] << '\"'
+				<< emit();
+		}
 		switch (opt) {
 		case OPT_FILE:	/* Read further options from file*/
 			save_ind = optind;
@@ -467,26 +548,21 @@ void options::parse_command_args(int argc, char *argv[])
 		case OPT_VERBOSE:
 			config_diagnostics("verbose");
 			break;
-		case OPT_DEF: { /* define a symbol*/
-            string s(optarg);
-			chewer<string> chew(false,s);
-			symbol::locator sloc(chew);
-			sloc->digest_global_define(chew);
-		}
-		break;
-		case OPT_UNDEF: { /* undef a symbol*/
-            string s(optarg);
-			chewer<string> chew(false,s);
-			symbol::locator sloc(chew);
-			sloc->digest_global_undef(chew);
-		}
-		break;
+		case OPT_DEF: /* define a symbol*/
+			define_symbol(optarg);
+			break;
+		case OPT_UNDEF: /* undef a symbol*/
+			undef_symbol(optarg);
+			break;
 		case OPT_COMPLEMENT: /* treat -D as -U and vice versa*/
 			_complement_ = true;
 			break;
 		case OPT_REPLACE:
 			_replace_ = true;
 			break;
+		case OPT_NULL: /* NUL-delimited filenames on stdin */
+			_null_delimited_ = true;
+			break;
 		case OPT_BACKUP:
 			_backup_suffix_ = optarg;
 			break;
@@ -579,6 +655,12 @@ void options::parse_command_args(int argc, char *argv[])
 		case OPT_FILTER: /* Filter input by file extensions*/
 			dataset::set_filter(optarg);
 			break;
+		case OPT_EXCLUDE: /* Exclude input files by pattern */
+			exclude_rules::add_file_pattern(optarg);
+			break;
+		case OPT_EXCLUDE_DIR: /* Exclude input directories by pattern */
+			exclude_rules::add_dir_pattern(optarg);
+			break;
 		case OPT_KEEPGOING: /* Continue to process subsequent in
 								put files after errors*/
 			_keepgoing_ = true;
@@ -614,18 +696,155 @@ void options::parse_command_args(int argc, char *argv[])
 			_selected_symbols_ = true;
 			break;
 		case OPT_EXPAND_MAX: {
-			/* Specify the limit size for reported macro expansions
+			/* Specify the size limit for macro expansions, in bytes
+				or with a K or M suffix
 			*/
 			char *endp;
-			_max_expansion_ = strtoul(optarg,&endp,10);
-			if (*endp && (*endp == 'K' || *endp == 'k')) {
-				_max_expansion_ *= 1024;
+			unsigned long limit = strtoul(optarg,&endp,10);
+			unsigned shift = 0;
+			if (*endp == 'K' || *endp == 'k') {
+				shift = 10;
+				++endp;
+			} else if (*endp == 'M' || *endp == 'm') {
+				shift = 20;
 				++endp;
 			}
-			if (*endp) {
+			/* Reject a limit that would overflow before it is scaled */
+			if (limit > (UINT_MAX >> shift)) {
+				limit = 0;
+			}
+			limit <<= shift;
+			if (*endp || !limit) {
 				error_usage() << "Invalid argument for --max-expansion: \""
 					<< optarg << '\"' << emit();
 			}
+			_max_expansion_ = unsigned(limit);
+		}
+		break;
+		case OPT_STATS:
+			/* Specify that a run summary is to be reported at exit */
+			_stats_ = true;
+			break;
+		case OPT_TRACE:
+			/* Specify a file to which a trace of the run is to be written */
+			trace::open(optarg);
+			break;
+		case OPT_TRACE_THRESHOLD: {
+			/* Specify the least duration in microseconds of a traced
+				directive evaluation
+			*/
+			char *endp;
+			unsigned long usecs = strtoul(optarg,&endp,10);
+			if (*endp || endp == optarg || usecs > UINT_MAX) {
+				error_usage() << "Invalid argument for --trace-threshold: \""
+					<< optarg << '\"' << emit();
+			}
+			trace::directive_threshold() = unsigned(usecs);
+		}
+		break;
+		case OPT_PROFILE_SYMBOLS: {
+			/* Specify the number of most costly symbols to be reported
+				at exit
+			*/
+			char *endp;
+			unsigned long n = strtoul(optarg,&endp,10);
+			if (*endp || !n || n > UINT_MAX) {
+				error_usage() << "Invalid argument for --profile-symbols: \""
+					<< optarg << '\"' << emit();
+			}
+			profile::top_symbols() = unsigned(n);
+		}
+		break;
+		case OPT_PROFILE_FILES: {
+			/* Specify the number of slowest files to be reported at exit */
+			char *endp;
+			unsigned long n = strtoul(optarg,&endp,10);
+			if (*endp || !n || n > UINT_MAX) {
+				error_usage() << "Invalid argument for --profile-files: \""
+					<< optarg << '\"' << emit();
+			}
+			profile::profile_files(unsigned(n));
+		}
+		break;
+		case OPT_PROFILE_FILES_CSV:
+			/* Specify a CSV file to which the costs of all files are
+				to be written at exit
+			*/
+			profile::profile_files(string(optarg));
+			break;
+		case OPT_FILE_BUDGET_MS: {
+			/* Specify the most milliseconds to be spent evaluating
+				the directives of a file
+			*/
+			char *endp;
+			unsigned long ms = strtoul(optarg,&endp,10);
+			if (*endp || !ms || ms > UINT_MAX) {
+				error_usage() << "Invalid argument for --file-budget-ms: \""
+					<< optarg << '\"' << emit();
+			}
+			file_budget::millisecs() = unsigned(ms);
+		}
+		break;
+		case OPT_EXPANSION_BUDGET: {
+			/* Specify the most macro-expansions to be performed in
+				evaluating the directives of a file
+			*/
+			char *endp;
+			unsigned long n = strtoul(optarg,&endp,10);
+			if (*endp || !n || n == ULONG_MAX) {
+				error_usage() << "Invalid argument for --expansion-budget: \""
+					<< optarg << '\"' << emit();
+			}
+			file_budget::expansions() = n;
+		}
+		break;
+		case OPT_PROGRESS:
+			/* Specify that progress is to be reported at intervals */
+			if (!progress_meter::interval()) {
+				progress_meter::interval() = progress_meter::default_interval;
+			}
+			break;
+		case OPT_PROGRESS_INTERVAL: {
+			/* Specify the interval in seconds between progress reports */
+			char *endp;
+			unsigned long secs = strtoul(optarg,&endp,10);
+			if (*endp || !secs || secs > UINT_MAX) {
+				error_usage() << "Invalid argument for --progress-interval: \""
+					<< optarg << '\"' << emit();
+			}
+			progress_meter::interval() = unsigned(secs);
+		}
+		break;
+		case OPT_SHARD: /* Specify the shard of the dataset to process */
+			shard::set(optarg);
+			/* A shard must not stop short of the files that a
+				single run would process after an error */
+			_keepgoing_ = true;
+			break;
+		case OPT_EXIT_CODES: /* Specify the exit codes of merged runs */
+			report_merge::add_exit_codes(optarg);
+			break;
+		case OPT_INDEX: /* Specify the symbol index file */
+			symbol_index::set(optarg);
+			break;
+		case OPT_COMPILE_DB: /* Specify a compilation database */
+			compile_db::set(optarg);
+			break;
+		case OPT_CONFIG: { /* Restore a precompiled configuration */
+			if (symbol::count()) {
+				error_usage() << "--config must precede any --define or "
+					"--undef and can only be used once" << emit();
+			}
+			vector<string> args = config_snapshot::load(optarg);
+			_config_args_.insert(_config_args_.end(),args.begin(),args.end());
+		}
+		break;
+		case OPT_EXPANSION_CACHE: /* Specify the expansion cache file */
+			expansion_cache::set(optarg);
+			break;
+		case OPT_CONFIG_HEADER: { /* define and undef symbols from a header */
+			vector<string> args = config_header::load(optarg);
+			_config_args_.insert(_config_args_.end(),args.begin(),args.end());
 		}
 		break;
 		default:
@@ -647,7 +866,7 @@ void options::parse_command_args(int argc, char *argv[])
 		}
 		if (_command_->cmd_code == CMD_SOURCE ||
 			_command_->cmd_code == CMD_SPIN) {
-			if (! options::implicit() &&
+			if (! options::implicit() && !compile_db::on() &&
 					symbol::count(symbol::provenance::global) == 0) {
 				warning_no_syms() <<
 					"You have not --define-ed or --undef-ed any symbols. "
@@ -656,13 +875,26 @@ void options::parse_command_args(int argc, char *argv[])
 			}
 		}
 	}
+	if (_parsing_config_) {
+		if (optind < argc) {
+			error_usage() << "Only options are valid in a compilation database entry, "
+				"not \"" << argv[optind] << '\"' << emit();
+		}
+		return;
+	}
 	if (argc) {
 		progress_building_tree() << "Building input tree" << emit();
 	}
 	argc -= optind;
 	argv += optind;
 	for (	; argc; --argc,++argv,++_cmd_line_files_) {
-		add_files(*argv);
+		if (_command_->cmd_code == CMD_MERGE) {
+			report_merge::add(*argv);
+		} else if (_command_->cmd_code == CMD_PRECOMPILE) {
+			config_snapshot::set_output(*argv);
+		} else {
+			add_files(*argv);
+		}
 	}
 }
 
@@ -691,6 +923,48 @@ void options::parse_file(string const & argsfile)
 	parse_command_args(int(arg_addrs.size()),&arg_addrs[0]);
 }
 
+void options::define_symbol(string arg)
+{
+	chewer<string> chew(false,arg);
+	symbol::locator sloc(chew);
+	sloc->digest_global_define(chew);
+	if (!_parsing_config_) {
+		_config_args_.push_back("-D" + arg);
+	}
+}
+
+void options::undef_symbol(string arg)
+{
+	chewer<string> chew(false,arg);
+	symbol::locator sloc(chew);
+	sloc->digest_global_undef(chew);
+	if (!_parsing_config_) {
+		_config_args_.push_back("-U" + arg);
+	}
+}
+
+void options::parse_config_args(vector<string> const & config_args)
+{
+	vector<string> args(1,_prog_name_);
+	std::vector<char *> arg_addrs;
+	set<string> ids;
+	for (string const & arg : config_args) {
+		ids.insert(config_arg_id(arg));
+	}
+	for (string const & arg : _config_args_) {
+		if (!ids.count(config_arg_id(arg))) {
+			args.push_back(arg);
+		}
+	}
+	args.insert(args.end(),config_args.begin(),config_args.end());
+	for (string & arg : args) {
+		arg_addrs.push_back(const_cast<char *>(arg.c_str()));
+	}
+	_parsing_file_ = _parsing_config_ = true;
+	parse_command_args(int(arg_addrs.size()),&arg_addrs[0]);
+	_parsing_file_ = _parsing_config_ = false;
+}
+
 void options::parse_executable(char **argv)
 {
 	_exec_path_ = string(*argv);
@@ -744,11 +1018,50 @@ void options::finish()
 		error_usage() << "--line is inconsistent with --discard blank|comment"
 			<< emit();
 	}
+	if (_stats_ || profile::files() || progress_meter::interval()) {
+		stats::start_counting();
+	}
+	if (cmd_code == CMD_MERGE) {
+		if (!report_merge::reports()) {
+			error_usage() << "The \"merge\" command needs report files"
+				<< emit();
+		}
+		return;
+	}
+	if (cmd_code == CMD_PRECOMPILE) {
+		if (config_snapshot::output().empty()) {
+			error_usage() << "The \"precompile-config\" command needs an "
+				"output file" << emit();
+		}
+		return;
+	}
+	if (compile_db::on()) {
+		for (string const & file : compile_db::load()) {
+			add_files(file);
+			++_cmd_line_files_;
+		}
+	}
 	if (_cmd_line_files_ == 0) {
 		/* No input files on command line*/
 		if (!_replace_) {
 			/* Without --replace, stdin is the input file*/
 			input_is_stdin = true;
+		} else if (_null_delimited_) {
+			/* With --null, stdin supplies blocks of input filenames */
+			vector<string> names;
+			vector<string> files;
+			while (io::read_filenames(names)) {
+				for (string & name : names) {
+					if (fs::is_file(fs::obj_type(name))) {
+						files.push_back(move(name));
+					} else {
+						add_files(name);
+					}
+				}
+				dataset::add(files);
+				names.clear();
+				files.clear();
+			}
 		} else {
 			/* With --replace, stdin supplies input filenames*/
 			string infile(io::read_filename());
@@ -756,6 +1069,9 @@ void options::finish()
 				(void)add_files(infile);
 			}
 		}
+	} else if (_null_delimited_) {
+		error_usage() << "--null applies only when input filenames are read "
+			"from stdin" << emit();
 	}
 	if (dataset::files() == 0 && !input_is_stdin) {
 		error_nothing_to_do() <<
@@ -767,6 +1083,24 @@ void options::finish()
 			  "The \"source\" command needs --replace to process multiple files"
 			  << emit();
 	}
+	if (compile_db::on()) {
+		compile_db::configure();
+	}
+	if (symbol_index::on()) {
+		if (!io::spin() || input_is_stdin) {
+			error_usage() << "--index needs --dir and input files" << emit();
+		}
+		if (compile_db::on()) {
+			error_usage() << "--index is inconsistent with --compile-db"
+				<< emit();
+		}
+	}
+	if (expansion_cache::on()) {
+		if (compile_db::on()) {
+			error_usage() <<
+				"--expansion-cache is inconsistent with --compile-db" << emit();
+		}
+	}
 	if (cmd_code == CMD_SYMBOLS) {
 		if (!_list_symbols_in_ifs_ &&
 		    !_list_symbols_in_defs_ &&
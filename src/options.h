@@ -80,7 +80,9 @@ enum command_code {
     CMD_ERRORS,	///< The errors command
     CMD_LINES,	///< The line command
     CMD_DIRECTIVES,	///< The directives command
-    CMD_SPIN	///< the spin command
+    CMD_SPIN,	///< the spin command
+    CMD_MERGE,	///< the merge command
+    CMD_PRECOMPILE	///< the precompile-config command
 };
 
 /// Manages coan's commandline arguments
@@ -109,6 +111,10 @@ struct  options {
 	static bool replace() {
 		return _replace_;
 	}
+	/// Are filenames read from stdin delimited by NUL?
+	static bool null_delimited() {
+		return _null_delimited_;
+	}
 	/// Do we report file and line numbers for listed items?
 	static bool list_location() {
 		return _list_locate_;
@@ -161,6 +167,10 @@ struct  options {
 	static bool complement() {
 		return _complement_;
 	}
+	/// Get the `--define` and `--undef` options of the commandline.
+	static std::vector<std::string> const & config_args() {
+		return _config_args_;
+	}
 	/** \brief Do we evaluate constants in truth-functional contexts or treat
 	 *   them as unknowns.
 	 */
@@ -209,10 +219,14 @@ struct  options {
 	static bool selected_symbols() {
 		return	_selected_symbols_;
 	}
-	/// Is symbol reporting restricted to a selected set?
+	/// Get the size limit in bytes for macro expansions
 	static unsigned & max_expansion() {
 		return	_max_expansion_;
 	}
+	/// Do we report a run summary at exit?
+	static bool stats() {
+		return	_stats_;
+	}
 
 	/// Say whether the current comment generates source code
 	static bool have_source_output() {
@@ -221,6 +235,19 @@ struct  options {
 		return yes;
 	}
 
+	/** \brief Say whether the operative command reports only directives.
+	 *
+	 *	When true, lines that cannot begin a directive and cannot open
+	 *	a lexical context that might hide one need not be parsed.
+	 */
+	static bool directives_only() {
+		static bool yes =
+				get_command() == CMD_INCLUDES || get_command() == CMD_DEFS ||
+				get_command() == CMD_PRAGMAS || get_command() == CMD_ERRORS ||
+				get_command() == CMD_LINES || get_command() == CMD_DIRECTIVES;
+		return yes;
+	}
+
 	/// Say whether items are reportable at most once per file
 	static bool list_at_most_once_per_file() {
 		static bool yes =
@@ -253,6 +280,24 @@ struct  options {
 	 */
 	static void finish();
 
+	/**	\brief Parse the options that configure a `compile_db`
+	 *	configuration.
+	 *
+	 *  \param	args	The `--define` and `--undef` options.
+	 *
+	 *  The `--define` and `--undef` options of the commandline are
+	 *	parsed again, followed by `args`. An option of the commandline
+	 *	is skipped if `args` has one for the same symbol.
+	 */
+	static void parse_config_args(std::vector<std::string> const & args);
+
+	/** \brief Get the name of the symbol of a `-D` or `-U` option.
+	 *  \param arg The option, with its argument attached.
+	 */
+	static std::string config_arg_id(std::string const & arg) {
+		return arg.substr(2,arg.find_first_of("=(",2) - 2);
+	}
+
 private:
 
 	/// Symbolic constants for the options of all coan commands
@@ -292,7 +337,27 @@ private:
 		OPT_SELECT = 7,			///< The `--select` option
 		OPT_LNS = 8,			///< The `--lns` option
 		OPT_EXPAND_MAX = 9,		///< The `--max-expansion` option
-		OPT_ONCE_PER_FILE = 10	///< The `--once-per-file` option
+		OPT_ONCE_PER_FILE = 10,	///< The `--once-per-file` option
+		OPT_STATS = 11,			///< The `--stats` option
+		OPT_TRACE = 12,			///< The `--trace` option
+		OPT_TRACE_THRESHOLD = 13,	///< The `--trace-threshold` option
+		OPT_PROFILE_SYMBOLS = 14,	///< The `--profile-symbols` option
+		OPT_PROFILE_FILES = 15,	///< The `--profile-files` option
+		OPT_PROFILE_FILES_CSV = 16,	///< The `--profile-files-csv` option
+		OPT_FILE_BUDGET_MS = 17,	///< The `--file-budget-ms` option
+		OPT_EXPANSION_BUDGET = 18,	///< The `--expansion-budget` option
+		OPT_PROGRESS = 19,		///< The `--progress` option
+		OPT_PROGRESS_INTERVAL = 20,	///< The `--progress-interval` option
+		OPT_SHARD = 21,			///< The `--shard` option
+		OPT_EXIT_CODES = 22,	///< The `--exit-codes` option
+		OPT_INDEX = 23,			///< The `--index` option
+		OPT_COMPILE_DB = 24,	///< The `--compile-db` option
+		OPT_CONFIG = 25,		///< The `--config` option
+		OPT_EXPANSION_CACHE = 26,	///< The `--expansion-cache` option
+		OPT_CONFIG_HEADER = 27,	///< The `--config-header` option
+		OPT_EXCLUDE = 28,		///< The `--exclude` option
+		OPT_EXCLUDE_DIR = 29,	///< The `--exclude-dir` option
+		OPT_NULL = '0'			///< The `--null` option
 	};
 
 	/** \brief Array of structures specifying the valid options for all coan
@@ -338,6 +403,12 @@ private:
 	/// Excluded options for the `spin` command.
 	static int const spin_cmd_exclusions[];
 
+	/// Excluded options for the `merge` command.
+	static int const merge_cmd_exclusions[];
+
+	/// Excluded options for the `precompile-config` command.
+	static int const precompile_cmd_exclusions[];
+
 	/** \brief Array of exclusion lists for the coan commands,
 	 *   indexed by command code.
 	 */
@@ -406,6 +477,18 @@ private:
 	 */
 	static void parse_file(std::string const & argsfile);
 
+	/**	\brief Digest the argument of a `--define` option.
+	 *
+	 *  \param	arg	The argument, `NAME[(PARAMS)][=DEFN]`.
+	 */
+	static void define_symbol(std::string arg);
+
+	/**	\brief Digest the argument of an `--undef` option.
+	 *
+	 *  \param	arg	The argument, `NAME`.
+	 */
+	static void undef_symbol(std::string arg);
+
 	/**	\brief Parse the options to the active coan command.
      *
 	 *  \param	argc	The number of arguments to be parsed.
@@ -428,6 +511,8 @@ private:
 	static bool	_got_opts_;
 	/// Do we replace input files with output files?
 	static bool	_replace_;
+	/// Are filenames read from stdin delimited by NUL?
+	static bool	_null_delimited_;
 	/// Do we report file and line numbers for listed items?
 	static bool	_list_locate_;
 	/// Do we report only the first occurrence of listed items?
@@ -482,6 +567,8 @@ private:
 	static bool _selected_symbols_;
 	/// Limit size for reported macro expansions
 	static unsigned _max_expansion_;
+	/// Do we report a run summary at exit?
+	static bool _stats_;
 	/// Bitmask of diagnostic filters
 	static int	_diagnostic_filter_;
 
@@ -494,6 +581,10 @@ private:
 
 	/// Are we parsing an argsfile ?
 	static bool _parsing_file_;
+	/// Are we parsing the options of a `compile_db` configuration?
+	static bool _parsing_config_;
+	/// The `--define` and `--undef` options of the commandline
+	static std::vector<std::string> _config_args_;
 };
 
 #endif // EOF
@@ -43,42 +43,38 @@ using namespace std;
 using namespace innards;
 
 parameter_list_base::parameter_list_base(size_t n)
-:	_params(n ? new vector<string>(n) : nullptr),
-    _defect(none),_variadic(false)
+:	_null(!n),_defect(none),_variadic(false)
 {
-    if (_params) {
-        for (unsigned i = 0; i < size(); ++i) {
-            (*_params)[i] = string("$") + to_string(i + 1);
-        }
+    for (unsigned i = 0; i < n; ++i) {
+        _params.push_back(string("$") + to_string(i + 1));
     }
 }
 
-string parameter_list_base::str() const
+void parameter_list_base::append_str(string & list) const
 {
-	string list;
-	if (_params) {
+	if (!_null) {
 		list.append(1,'(');
-		auto start = _params->begin();
-		auto const end = _params->end();
-		for (	; start < end - 1; ++start) {
+		auto start = _params.begin();
+		auto const end = _params.end();
+		for (	; start < end; ++start) {
+			if (start != _params.begin()) {
+				list.append(1,',');
+			}
 			list.append(*start);
-			list.append(1,',');
 		}
-		list.append(*start);
 		if (_defect != unclosed) {
 			list.append(1,')');
 		}
 	}
-	return list;
 }
 
 size_t parameter_list_base::which(std::string const & str) const
 {
-	if (!_params) {
+	if (_null) {
 		return -1;
 	}
-	auto where = find(_params->begin(),_params->end(),str);
-	return where == _params->end() ? string::npos : where - _params->begin();
+	auto where = find(_params.begin(),_params.end(),str);
+	return where == _params.end() ? string::npos : where - _params.begin();
 }
 
 // EOF
@@ -35,9 +35,8 @@
  *                                                                         *
  **************************************************************************/
 #include "chew.h"
+#include "small_vector.h"
 #include <string>
-#include <vector>
-#include <memory>
 #include <stdexcept>
 
 /** \file parameter_list_base.h
@@ -55,6 +54,13 @@ namespace innards {
  */
 struct parameter_list_base {
 
+	/** \brief Type of the container of parameters.
+	 *
+	 *	Most macros take no more than a few parameters, so up to 4
+	 *	are held without heap allocation.
+	 */
+	using params_type = small_vector<std::string,4>;
+
 	/** \brief Constructor for `n` parameters
      *
      *  \param n The number of parameters.
@@ -73,30 +79,30 @@ struct parameter_list_base {
      */
 	template<class CharSeq>
 	explicit parameter_list_base(chewer<CharSeq> & chew)
-	: _defect(none),_variadic(false) {
+	: _null(true),_defect(none),_variadic(false) {
 		read(chew);
 	}
 
 	/// Copy constructor.
-	parameter_list_base(parameter_list_base const & other)
-	:	 _params(
-		other._params ?
-			new std::vector<std::string>(*other._params) : nullptr),
-		_defect(other._defect),
-		_variadic(other._variadic){}
+	parameter_list_base(parameter_list_base const & other) = default;
+
+	/// Move constructor.
+	parameter_list_base(parameter_list_base && other) = default;
 
 	/// Swap with another `parameter_list_base`
 	void swap(parameter_list_base & other) {
 		std::swap(_params,other._params);
+		std::swap(_null,other._null);
 		std::swap(_defect,other._defect);
 		std::swap(_variadic,other._variadic);
 	}
 
-	/// Assignment
-	parameter_list_base & operator=(parameter_list_base other) {
-		swap(other);
-		return *this;
-	}
+	/// Copy assignment
+	parameter_list_base &
+	operator=(parameter_list_base const & other) = default;
+
+	/// Move assignment
+	parameter_list_base & operator=(parameter_list_base && other) = default;
 
 	/// Equality
 	bool operator==(parameter_list_base const & other) const {
@@ -124,12 +130,12 @@ struct parameter_list_base {
 	 *	parameter list ""
 	 */
 	size_t size() const {
-		return _params ? _params->size() : 0;
+		return _params.size();
 	}
 
 	/// Say whether the `parameter_list_base` is null, i.e. is not even "()"
 	bool null() const {
-		return !_params;
+		return _null;
 	}
 
 	/// Cast to boolean = !null()
@@ -138,23 +144,28 @@ struct parameter_list_base {
 	}
 
 	/// Cast the parameter list to its canonical string representation
-	std::string str() const;
+	std::string str() const {
+		std::string list;
+		append_str(list);
+		return list;
+	}
+
+	/// Append the canonical string representation of the list to `s`
+	void append_str(std::string & s) const;
 
 
     ///@{
     /** \brief Get a [const] iterator to the start of the parameter list.
      *
      *  \return An iterator to the start of the parameter list,
-     *  or `std::vector<string>::iterator()` if `null()` is true
+     *  which equals `end()` if `null()` is true
      */
-    std::vector<std::string>::iterator begin() {
-        using namespace std;
-        return null() ? vector<string>::iterator() : _params->begin();
+    params_type::iterator begin() {
+        return _params.begin();
     }
 
-    std::vector<std::string>::const_iterator begin() const {
-        using namespace std;
-        return null() ? vector<string>::const_iterator() : _params->begin();
+    params_type::const_iterator begin() const {
+        return _params.begin();
     }
     ///@}
 
@@ -162,16 +173,14 @@ struct parameter_list_base {
     /** \brief Get a [const] iterator to the end of the parameter list.
      *
      *  \return An iterator to the end of the parameter list,
-     *  or `std::vector<string>::iterator()` if `null()` is true
+     *  which equals `begin()` if `null()` is true
      */
-    std::vector<std::string>::iterator end() {
-        using namespace std;
-        return null() ? vector<string>::iterator() : _params->end();
+    params_type::iterator end() {
+        return _params.end();
     }
 
-    std::vector<std::string>::const_iterator end() const {
-        using namespace std;
-        return null() ? vector<string>::const_iterator() : _params->end();
+    params_type::const_iterator end() const {
+        return _params.end();
     }
     ///@}
 
@@ -187,7 +196,7 @@ struct parameter_list_base {
         if (!size()) {
             throw out_of_range("Out of range in parameter_list_base::at(size_t)");
         }
-        return (*_params)[n];
+        return _params[n];
     }
 
     std::string & at(size_t n) {
@@ -195,7 +204,7 @@ struct parameter_list_base {
         if (!size()) {
             throw out_of_range("Out of range in parameter_list_base::at(size_t)");
         }
-        return (*_params)[n];
+        return _params[n];
     }
     ///@}
 
@@ -206,11 +215,11 @@ struct parameter_list_base {
      *  \throw `std::out_of_range` on out-of-range error
      */
     std::string const & operator[](size_t n) const {
-        return (*_params)[n];
+        return _params[n];
     }
 
     std::string & operator[](size_t n) {
-        return (*_params)[n];
+        return _params[n];
     }
     ///@}
 
@@ -270,7 +279,9 @@ protected:
 	};
 
 	/// The list of parameters
-	std::shared_ptr<std::vector<std::string>> _params;
+	params_type _params;
+	/// Is the `parameter_list_base` null, i.e. not even "()"?
+	bool _null;
 	/// Is the `parameter_list_base` well-formed?
 	defect _defect;
 	/// Is the `parameter_list_base` variadic?
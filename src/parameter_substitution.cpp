@@ -37,6 +37,7 @@
 #include "parameter_substitution.h"
 #include "diagnostic.h"
 #include "symbol.h"
+#include <algorithm>
 
 /** \file parameter_substitution.cpp
  *   This file implements the members of `namespace parameter_substitution`.
@@ -194,6 +195,63 @@ void format::build_format(symbol & sym)
 	do_token_paste_adjustments();
 }
 
+void format::tokenize()
+{
+	chewer<string> chew(chew_mode::plaintext,_fmt);
+	size_t run = 0;
+	while (chew) {
+		chew(literal_space);
+		size_t mark = size_t(chew);
+		specifier spec = specifier::read(chew);
+		if (spec) {
+			if (mark > run) {
+				_tokens.push_back(token{run,mark - run,specifier()});
+			}
+			_tokens.push_back(token{mark,specifier::serialized_size,spec});
+			run = size_t(chew);
+		} else if (chew && identifier::is_start_char(*chew)) {
+			string id = identifier::read(chew);
+			auto where = lower_bound(_names.begin(),_names.end(),id);
+			if (where == _names.end() || *where != id) {
+				_names.insert(where,id);
+			}
+		} else if (chew) {
+			++chew;
+		}
+	}
+	if (_fmt.size() > run) {
+		_tokens.push_back(token{run,_fmt.size() - run,specifier()});
+	}
+}
+
+format::resolution format::resolve(string const & id, symbol *& sym) const
+{
+	auto where = lower_bound(_names.begin(),_names.end(),id);
+	if (where == _names.end() || *where != id) {
+		return resolution::unlisted;
+	}
+	if (_bindings.size() != _names.size() ||
+			_epoch != symbol::table_epoch()) {
+		_bindings.assign(_names.size(),binding());
+		_epoch = symbol::table_epoch();
+	}
+	binding & b = _bindings[where - _names.begin()];
+	if (!b._sym) {
+		size_t absent_at = symbol::count() + 1;
+		if (b._absent_at == absent_at) {
+			return resolution::absent;
+		}
+		symbol::locator loc = symbol::lookup(id);
+		if (!loc) {
+			b._absent_at = absent_at;
+			return resolution::absent;
+		}
+		b._sym = &*loc;
+	}
+	sym = b._sym;
+	return resolution::found;
+}
+
 format::format(symbol & sym)
 {
 	if (!sym.defn()) {
@@ -214,6 +272,7 @@ format::format(symbol & sym)
 		gripe << "##-operator does not compose a token in definition >>"
 		<< *sym.defn() << "<< of \"" << sym.signature() << '\"' << emit();
 	}
+	tokenize();
 }
 
 std::string format::legible(string const & str)
@@ -44,6 +44,7 @@
 // Forward decl
 struct symbol;
 struct parameter_list;
+struct config_snapshot;
 
 /** \file parameter_substitution.h
  *
@@ -256,6 +257,21 @@ private:
  */
 struct format
 {
+	/** \brief A token of a pre-tokenized format.
+	 *
+	 *	A token is either a run of literal text from the format string
+	 *	or a parameter substitution specifier.
+	 */
+	struct token
+	{
+		/// Offset of the token in the format string
+		size_t off;
+		/// Length of the token in the format string
+		size_t len;
+		/// The specifier of a parameter token; null for a literal run
+		specifier spec;
+	};
+
 	/// \brief Construct a parameter substitution format for a given symbol
 	explicit format(symbol & sym);
 
@@ -264,6 +280,45 @@ struct format
 		return _fmt;
 	}
 
+	/** \brief Get the tokens of the format.
+	 *
+	 *	The tokens partition the format string, in order, into literal runs
+	 *	and parameter specifiers, so that arguments can be spliced into
+	 *	the format without re-scanning it.
+	 */
+	std::vector<token> const & tokens() const {
+		return _tokens;
+	}
+
+	/// Say whether any identifier occurs in the format outside literals
+	bool has_names() const {
+		return !_names.empty();
+	}
+
+	/// Outcomes of resolving an identifier against the format
+	enum class resolution {
+		found,	///< The identifier names a symbol in the symbol table
+		absent,	///< The identifier is not in the symbol table
+		unlisted	///< The identifier does not occur in the format
+	};
+
+	/** \brief Resolve an identifier of the format to a symbol.
+	 *
+	 *	\param id An identifier.
+	 *	\param sym On return, receives a pointer to the symbol named `id`
+	 *		if the result is `resolution::found`, else is unchanged.
+	 *	\return `resolution::unlisted` if `id` does not occur in the
+	 *		format outside literals, else whether it is in the symbol
+	 *		table.
+	 *
+	 *	Each identifier is looked up in the symbol table once. A symbol
+	 *	found is kept until `symbol::table_epoch()` changes. A symbol not
+	 *	found is taken to be absent until the symbol table grows. So
+	 *	rescanning an expansion of the format need not look up its
+	 *	identifiers again.
+	 */
+	resolution resolve(std::string const & id, symbol *& sym) const;
+
 	/// Get a string legibly representing the format
 	std::string legible() const;
 
@@ -274,6 +329,12 @@ struct format
 
 private:
 
+	/// A precompiled configuration saves and restores formats.
+	friend struct ::config_snapshot;
+
+	/// Construct an empty format
+	format() = default;
+
 	/** \brief Build a format with appropriate specifiers inserted
 	 *	at all parameter positions
      *
@@ -353,8 +414,29 @@ private:
 	 */
 	ptrdiff_t adjust_for_token_paste_op(size_t pos);
 
+	/// Partition the finished format string into `token`s.
+	void tokenize();
+
 	/// The format string.
 	std::string _fmt;
+	/// The tokens of the format string.
+	std::vector<token> _tokens;
+	/// The resolution of an identifier in `_names`
+	struct binding {
+		/// The symbol named, if found.
+		symbol * _sym = nullptr;
+		/** 1 + `symbol::count()` when the symbol was not found,
+			else 0 */
+		size_t _absent_at = 0;
+	};
+
+	/** The distinct identifiers occurring in the format outside literals,
+		in ascending order */
+	std::vector<std::string> _names;
+	/// The resolutions of `_names`, by index
+	mutable std::vector<binding> _bindings;
+	/// The `symbol::table_epoch()` at which `_bindings` were made
+	mutable unsigned _epoch = 0;
 	/// Vector of offsets of `#`-operators
 	std::vector<size_t> _stringify_offs;
 	/// Vector of offset of `##`-operators
@@ -46,6 +46,9 @@
 #include "options.h"
 #include "diagnostic.h"
 #include "citable.h"
+#include "contradiction.h"
+#include "stats.h"
+#include <cstring>
 
 /// \cond NO_DOXYGEN
 
@@ -53,6 +56,23 @@ using namespace std;
 
 size_t parsed_line::extend()
 {
+	if (!_in) {
+		size_t bytes = _map_end - _map_pos;
+		if (!bytes) {
+			return 0;
+		}
+		auto nl = static_cast<char const *>(memchr(_map_pos,'\n',bytes));
+		if (nl) {
+			bytes = nl + 1 - _map_pos;
+		} else {
+			warning_missing_eof_newline() <<
+				"Missing newline at end of file" << emit();
+		}
+		_text.append(_map_pos,bytes);
+		_map_pos += bytes;
+		++_lineno;
+		return bytes;
+	}
 	string line;
 	getline(*_in,line);
 	if (_in->fail() && !_in->eof()) {
@@ -92,11 +112,41 @@ bool parsed_line::get()
 	_extensions = 0;
 	_simplified = false;
 	clear();
+	if (!_in) {
+		skim();
+	}
 	got = extend();
 	set_dropping();
 	return got;
 }
 
+void parsed_line::skim()
+{
+	if (contradiction::pending()) {
+		return;
+	}
+	char const * line = _map_pos;
+	unsigned lineno = _lineno;
+	for (char const * p = line; p != _map_end; ++p) {
+		switch(*p) {
+		case '\n':
+			++_lineno;
+			line = p + 1;
+			continue;
+		case '#':
+		case '/':
+		case '"':
+		case '\'':
+		case '\\':
+			break;
+		default:
+			continue;
+		}
+		break;
+	}
+	_map_pos = line;
+	stats::count_lines(_lineno - lineno);
+}
 
 void parsed_line::keyword_lop(std::string const & keyword) {
 	_text.resize(_keyword_posn);
@@ -285,6 +335,7 @@ void parsed_line::output()
 {
 	command_code cmd = options::get_command();
 	if (cmd == CMD_SOURCE || cmd == CMD_SPIN) {
+		stats::timer timing(stats::phase::output);
 		if (options::line_directives()) {
 			if (_drop_run_length) {
 				_drop_run_length = 0;
@@ -304,6 +355,7 @@ void parsed_line::drop()
 {
 	if (options::get_command() == CMD_SOURCE
 		|| options::get_command() == CMD_SPIN) {
+		stats::timer timing(stats::phase::output);
 		write(false);
 		if (options::line_directives()) {
 			++_drop_run_length;
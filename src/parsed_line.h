@@ -57,6 +57,20 @@ struct parsed_line : parse_buffer
     :	_in(in),
         _out(out){}
 
+	/** \brief Construct given the bounds of a memory-mapped input file
+	 *	and a pointer to an output stream.
+	 *
+	 *	A `parsed_line` so constructed reads from the mapped contents
+	 *	and will skim past lines that are of no interest
+	 *	when `options::directives_only()` is true.
+	 */
+	explicit parsed_line(char const * begin, char const * end,
+						std::ostream * out)
+    :	_in(nullptr),
+        _out(out),
+        _map_pos(begin),
+        _map_end(end){}
+
 	~parsed_line() override {}
 
 	/** \brief Get a pointer to the input stream from which this `parsed_line`
@@ -179,6 +193,18 @@ protected:
 	/// Try to read another line of input, returning the number of bytes read.
 	size_t extend() override;
 
+	/** \brief Skip past mapped input lines that cannot matter to a
+	 *	directives-only command.
+	 *
+	 *	Lines are skipped while they contain none of the characters
+	 *	`#`, `/`, `"`, `'` or `\`. Such a line can neither be a
+	 *	directive nor open a comment, literal or continuation that might
+	 *	affect the parsing of a following line, so it is only counted.
+	 *	Nothing is skipped while a contradiction is pending, since
+	 *	the next line discharges it.
+	 */
+	void skim();
+
 	/** \brief Convert the directive in the line into a
 	 *	another one that has no argument.
      *
@@ -228,6 +254,10 @@ protected:
 	std::istream * _in;
 	/// The output stream to which this line is written
 	std::ostream * _out;
+	/// The read position in mapped input, if the input is mapped
+	char const * _map_pos = nullptr;
+	/// The end of mapped input, if the input is mapped
+	char const * _map_end = nullptr;
 	/// Offset to directive keyword, if any.
 	size_t	_keyword_posn = 0;
 	/// Length of directive keyword, if any
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "profile.h"
+#include "options.h"
+#include "stats.h"
+#include "io.h"
+#include "diagnostic.h"
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+
+/** \file profile.cpp
+ *   This file implements `struct profile`
+ */
+
+using namespace std;
+
+unsigned profile::_top_symbols_ = 0;
+unordered_map<string,profile::cost> profile::_symbols_;
+profile::digest_timer * profile::_current_ = nullptr;
+bool profile::_files_on_ = false;
+unsigned profile::_top_files_ = 0;
+string profile::_files_csv_;
+vector<profile::file_cost> profile::_files_;
+
+void profile::digest_timer::start()
+{
+	_nested = chrono::steady_clock::duration::zero();
+	_outer = _current_;
+	_current_ = this;
+	_start = chrono::steady_clock::now();
+}
+
+void profile::digest_timer::stop()
+{
+	chrono::steady_clock::duration elapsed =
+		chrono::steady_clock::now() - _start;
+	cost & c = _symbols_[*_id];
+	++c._digests;
+	c._total += elapsed;
+	c._self += elapsed - _nested;
+	_current_ = _outer;
+	if (_outer) {
+		_outer->_nested += elapsed;
+	}
+}
+
+void profile::report_symbols(ostream & out)
+{
+	using msecs = chrono::duration<double,milli>;
+	using entry = pair<string const,cost> const *;
+	vector<entry> ranked;
+	ranked.reserve(_symbols_.size());
+	for (auto const & sym : _symbols_) {
+		ranked.push_back(&sym);
+	}
+	size_t n = min(size_t(_top_symbols_),ranked.size());
+	partial_sort(ranked.begin(),ranked.begin() + n,ranked.end(),
+		[](entry lhs, entry rhs) {
+			return lhs->second._self > rhs->second._self ||
+				(lhs->second._self == rhs->second._self &&
+					lhs->first < rhs->first);
+		});
+	out << options::prog_name() << " symbol profile: top " << n << " of " <<
+		ranked.size() << " symbols by self time\n";
+	out << "  " << left << setw(32) << "symbol" << right <<
+		setw(12) << "self ms" << setw(12) << "total ms" <<
+		setw(10) << "digests" << setw(12) << "expansions" <<
+		setw(12) << "max bytes" << setw(14) << "invalidations" << '\n';
+	out << fixed << setprecision(3);
+	for (size_t i = 0; i < n; ++i) {
+		cost const & c = ranked[i]->second;
+		out << "  " << left << setw(32) << ranked[i]->first << right <<
+			setw(12) << msecs(c._self).count() <<
+			setw(12) << msecs(c._total).count() <<
+			setw(10) << c._digests << setw(12) << c._expansions <<
+			setw(12) << c._max_expansion << setw(14) << c._invalidations <<
+			'\n';
+	}
+	out.unsetf(ios::floatfield);
+}
+
+void profile::file_timer::start(string const & filename)
+{
+	file_cost c;
+	c._name = filename;
+	c._lines = stats::lines();
+	c._directives = stats::directives();
+	c._expansions = stats::expansions();
+	c._bytes = io::bytes_written();
+	c._abandoned = false;
+	_files_.push_back(c);
+	_start = chrono::steady_clock::now();
+}
+
+void profile::file_timer::stop()
+{
+	file_cost & c = _files_.back();
+	c._wall = chrono::steady_clock::now() - _start;
+	c._lines = stats::lines() - c._lines;
+	c._directives = stats::directives() - c._directives;
+	c._expansions = stats::expansions() - c._expansions;
+	c._bytes = io::bytes_written() - c._bytes;
+	c._abandoned = _abandoned;
+}
+
+void profile::profile_files(unsigned top)
+{
+	_files_on_ = true;
+	_top_files_ = top;
+	io::count_output();
+}
+
+void profile::profile_files(string const & csv_file)
+{
+	_files_on_ = true;
+	_files_csv_ = csv_file;
+	io::count_output();
+}
+
+void profile::write_files_csv()
+{
+	using secs = chrono::duration<double>;
+	ofstream out(_files_csv_.c_str());
+	if (!out.is_open()) {
+		abend_cant_open_output() << "Can't open " <<
+			_files_csv_ << " for writing" << emit();
+	}
+	out << "file,wall_s,lines,directives,expansions,bytes_written,abandoned\n";
+	out << fixed << setprecision(6);
+	for (file_cost const & c : _files_) {
+		out << '\"';
+		for (char ch : c._name) {
+			out << ch;
+			if (ch == '\"') {
+				out << ch;
+			}
+		}
+		out << "\"," << secs(c._wall).count() << ',' << c._lines << ',' <<
+			c._directives << ',' << c._expansions << ',' << c._bytes << ',' <<
+			int(c._abandoned) << '\n';
+	}
+}
+
+void profile::report_files(ostream & out)
+{
+	using msecs = chrono::duration<double,milli>;
+	if (!_files_csv_.empty()) {
+		write_files_csv();
+	}
+	if (!_top_files_) {
+		return;
+	}
+	vector<file_cost const *> ranked;
+	ranked.reserve(_files_.size());
+	for (file_cost const & c : _files_) {
+		ranked.push_back(&c);
+	}
+	size_t n = min(size_t(_top_files_),ranked.size());
+	partial_sort(ranked.begin(),ranked.begin() + n,ranked.end(),
+		[](file_cost const * lhs, file_cost const * rhs) {
+			return lhs->_wall > rhs->_wall;
+		});
+	out << options::prog_name() << " file profile: top " << n << " of " <<
+		ranked.size() << " files by time\n";
+	out << "  " << setw(12) << "ms" << setw(10) << "lines" <<
+		setw(12) << "directives" << setw(12) << "expansions" <<
+		setw(14) << "bytes out" << "  file\n";
+	out << fixed << setprecision(3);
+	for (size_t i = 0; i < n; ++i) {
+		file_cost const & c = *ranked[i];
+		out << "  " << setw(12) << msecs(c._wall).count() <<
+			setw(10) << c._lines << setw(12) << c._directives <<
+			setw(12) << c._expansions << setw(14) << c._bytes << "  " <<
+			c._name << (c._abandoned ? " (abandoned)" : "") << '\n';
+	}
+	out.unsetf(ios::floatfield);
+}
+
+// EOF
@@ -0,0 +1,255 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include "prohibit.h"
+#include <string>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#include <ostream>
+
+/** \file profile.h
+ *   This file defines `struct profile`
+ */
+
+/** \brief `struct profile` charges the costs of a run to the symbols
+ *	and the files that incur them.
+ *
+ *  For the `--profile-symbols` option, each symbol is charged with the time
+ *	spent digesting its references, the number and greatest size of its
+ *	macro-expansions and the number of times it is invalidated. References
+ *	that are expanded within the macro-expansion of another are charged to
+ *	their own symbols.
+ *
+ *	For the `--profile-files` and `--profile-files-csv` options, each file
+ *	is charged with the time spent processing it and the numbers of lines,
+ *	directives and macro-expansions read from it and bytes written for it.
+ *
+ *	Nothing is recorded for symbols or files unless the corresponding
+ *	options are in force.
+ */
+struct profile {
+
+	/** \brief `struct profile::digest_timer` charges the time of its
+	 *	lifetime to a symbol.
+	 *
+	 *	Timers nest: the time of an inner timer is charged to the
+	 *	inner symbol and is excluded from the self time of the outer one.
+	 */
+	struct digest_timer : private no_copy {
+
+		/// Explicitly construct given the name of the symbol to charge.
+		explicit digest_timer(std::string const & id)
+		: _id(_top_symbols_ ? &id : nullptr) {
+			if (_id) {
+				start();
+			}
+		}
+
+		/// Destructor charges the symbol.
+		~digest_timer() {
+			if (_id) {
+				stop();
+			}
+		}
+
+	private:
+
+		/// Start timing.
+		void start();
+		/// Stop timing and charge the symbol.
+		void stop();
+
+		/// The name of the symbol to charge, if profiling.
+		std::string const * _id;
+		/// The time at which the timer started.
+		std::chrono::steady_clock::time_point _start;
+		/// The time charged to timers nested in this one.
+		std::chrono::steady_clock::duration _nested;
+		/// The enclosing timer, if any.
+		digest_timer * _outer;
+	};
+
+	/** \brief `struct profile::file_timer` charges the costs of its
+	 *	lifetime to an input file.
+	 */
+	struct file_timer : private no_copy {
+
+		/// Explicitly construct given the name of the file to charge.
+		explicit file_timer(std::string const & filename)
+		: _on(_files_on_) {
+			if (_on) {
+				start(filename);
+			}
+		}
+
+		/// Destructor charges the file.
+		~file_timer() {
+			if (_on) {
+				stop();
+			}
+		}
+
+		/// Record that processing of the file was abandoned.
+		void abandon() {
+			_abandoned = true;
+		}
+
+	private:
+
+		/// Start recording.
+		void start(std::string const & filename);
+		/// Stop recording and charge the file.
+		void stop();
+
+		/// Is the file being profiled?
+		bool _on;
+		/// The time at which recording started.
+		std::chrono::steady_clock::time_point _start;
+		/// Was processing of the file abandoned?
+		bool _abandoned = false;
+	};
+
+	/** \brief Get a reference to the number of symbols to report,
+	 *	most costly first. If 0, symbols are not profiled.
+	 */
+	static unsigned & top_symbols() {
+		return _top_symbols_;
+	}
+
+	/** \brief Charge a macro-expansion to a symbol.
+	 *
+	 *	\param id The name of the symbol.
+	 *	\param size The size in bytes of the expansion.
+	 */
+	static void charge_expansion(std::string const & id, size_t size) {
+		if (_top_symbols_) {
+			cost & c = _symbols_[id];
+			++c._expansions;
+			if (size > c._max_expansion) {
+				c._max_expansion = size;
+			}
+		}
+	}
+
+	/** \brief Charge an invalidation to a symbol.
+	 *
+	 *	\param id The name of the symbol.
+	 */
+	static void charge_invalidation(std::string const & id) {
+		if (_top_symbols_) {
+			++_symbols_[id]._invalidations;
+		}
+	}
+
+	/// Write the report of the most costly symbols to a stream.
+	static void report_symbols(std::ostream & out);
+
+	/** \brief Profile files, reporting the given number of them,
+	 *	slowest first.
+	 */
+	static void profile_files(unsigned top);
+
+	/// Profile files, writing a record of each to a CSV file.
+	static void profile_files(std::string const & csv_file);
+
+	/// Say whether files are profiled.
+	static bool files() {
+		return _files_on_;
+	}
+
+	/// Write the report of the slowest files, or the CSV file, or both.
+	static void report_files(std::ostream & out);
+
+private:
+
+	/// The costs charged to a symbol.
+	struct cost {
+		/// Time spent digesting references, excluding nested ones.
+		std::chrono::steady_clock::duration _self =
+			std::chrono::steady_clock::duration::zero();
+		/// Time spent digesting references, including nested ones.
+		std::chrono::steady_clock::duration _total =
+			std::chrono::steady_clock::duration::zero();
+		/// The number of references digested.
+		unsigned long _digests = 0;
+		/// The number of macro-expansions.
+		unsigned long _expansions = 0;
+		/// The size of the largest macro-expansion.
+		size_t _max_expansion = 0;
+		/// The number of invalidations.
+		unsigned long _invalidations = 0;
+	};
+
+	/// The costs charged to a file.
+	struct file_cost {
+		/// The name of the file.
+		std::string _name;
+		/// Time spent processing the file.
+		std::chrono::steady_clock::duration _wall;
+		/// The number of lines read.
+		unsigned long _lines;
+		/// The number of directives read.
+		unsigned long _directives;
+		/// The number of macro-expansions.
+		unsigned long _expansions;
+		/// The number of bytes written.
+		unsigned long long _bytes;
+		/// Was processing of the file abandoned?
+		bool _abandoned;
+	};
+
+	/// Write the CSV file of file costs
+	static void write_files_csv();
+
+	/// The number of symbols to report.
+	static unsigned _top_symbols_;
+	/// The costs charged to each symbol.
+	static std::unordered_map<std::string,cost> _symbols_;
+	/// The innermost running `digest_timer`, if any.
+	static digest_timer * _current_;
+	/// Are files profiled?
+	static bool _files_on_;
+	/// The number of files to report.
+	static unsigned _top_files_;
+	/// The name of the CSV file of file costs, if any.
+	static std::string _files_csv_;
+	/// The costs charged to each file.
+	static std::vector<file_cost> _files_;
+};
+
+#endif // EOF
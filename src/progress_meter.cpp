@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "progress_meter.h"
+#include "platform.h"
+#include "dataset.h"
+#include "options.h"
+#include "stats.h"
+#include "filesys.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <csignal>
+#ifdef NIX
+#include <signal.h>
+#endif
+
+/** \file progress_meter.cpp
+ *   This file implements `struct progress_meter`
+ */
+
+using namespace std;
+
+/// Has `SIGUSR1` been received and not yet serviced?
+static volatile sig_atomic_t signalled = 0;
+
+unsigned progress_meter::_interval_ = 0;
+bool progress_meter::_armed_ = false;
+unsigned progress_meter::_polls_ = 0;
+unsigned progress_meter::_done_files_ = 0;
+unsigned long long progress_meter::_total_bytes_ = 0;
+unsigned long long progress_meter::_done_bytes_ = 0;
+progress_meter::clock::time_point progress_meter::_start_;
+progress_meter::clock::time_point progress_meter::_next_;
+
+/// Format a number of seconds as `H:MM:SS`
+static string hms(double secs)
+{
+	unsigned long s = (unsigned long)(secs + 0.5);
+	ostringstream out;
+	out << s / 3600 << ':' << setfill('0') << setw(2) << s / 60 % 60 <<
+		':' << setw(2) << s % 60;
+	return out.str();
+}
+
+void progress_meter::arm()
+{
+#ifdef NIX
+	struct sigaction action;
+	action.sa_handler = on_signal;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1,&action,nullptr);
+	_armed_ = true;
+	stats::start_counting();
+#endif
+}
+
+void progress_meter::on_signal(int)
+{
+	signalled = 1;
+}
+
+void progress_meter::count_file(string const & filename)
+{
+	_total_bytes_ += fs::file_size(filename);
+}
+
+void progress_meter::uncount_file(string const & filename)
+{
+	_total_bytes_ -= min(_total_bytes_,fs::file_size(filename));
+}
+
+void progress_meter::start()
+{
+	_start_ = clock::now();
+	_next_ = _start_ + chrono::seconds(_interval_);
+}
+
+void progress_meter::done_file(string const & filename)
+{
+	++_done_files_;
+	_done_bytes_ += fs::file_size(filename);
+	clock::time_point now = clock::now();
+	if (now >= _next_) {
+		report(now);
+	}
+}
+
+void progress_meter::service()
+{
+	if (signalled) {
+		signalled = 0;
+		stats::report(cerr);
+		cerr.flush();
+	}
+	if (_interval_) {
+		clock::time_point now = clock::now();
+		if (now >= _next_) {
+			report(now);
+		}
+	}
+}
+
+void progress_meter::report(clock::time_point now)
+{
+	_next_ = now + chrono::seconds(_interval_);
+	double secs = chrono::duration<double>(now - _start_).count();
+	unsigned files = dataset::files();
+	unsigned done = _done_files_;
+	ostringstream out;
+	out << fixed << setprecision(1) << options::prog_name() <<
+		" progress: " << done << " of " << files << " files";
+	if (files) {
+		out << " (" << 100.0 * done / files << "%)";
+	}
+	if (secs > 0) {
+		out << ", " << done / secs << " files/s, " <<
+			setprecision(0) << stats::lines() / secs << " lines/s, " <<
+			setprecision(2) << _done_bytes_ / secs / 1048576 << " MB/s";
+	}
+	double remaining = -1;
+	if (_total_bytes_ && _done_bytes_) {
+		remaining = secs * (_total_bytes_ - min(_done_bytes_,_total_bytes_)) /
+			_done_bytes_;
+	} else if (done) {
+		remaining = secs * (files - min(done,files)) / done;
+	}
+	out << ", ETA " << (remaining < 0 ? string("unknown") : hms(remaining));
+	cerr << out.str() << endl;
+}
+
+// EOF
@@ -0,0 +1,162 @@
+#ifndef PROGRESS_METER_H
+#define PROGRESS_METER_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include <chrono>
+#include <string>
+
+/** \file progress_meter.h
+ *   This file defines `struct progress_meter`
+ */
+
+/** \brief `struct progress_meter` reports the progress of a run while it
+ *	is in progress.
+ *
+ *  With the `--progress` option, a line is written to stderr at intervals
+ *	giving the number of files processed so far out of the number in the
+ *	`dataset`, the rates of files, lines and bytes processed per second and
+ *	the estimated time to completion. The estimate is based on the
+ *	cumulative bytes of the files processed, if the sizes of the files are
+ *	known, and otherwise on the number of files.
+ *
+ *	On Unix-like hosts, the current run summary, as reported by `--stats`,
+ *	is written to stderr whenever the process receives `SIGUSR1` while it
+ *	traverses the `dataset`.
+ *
+ *	The signal handler only raises a flag. The flag, and the clock for the
+ *	interval, are checked at safe points between input lines.
+ */
+struct progress_meter {
+
+	/// The default interval in seconds between progress reports.
+	static constexpr unsigned default_interval = 5;
+
+	/** \brief Get a reference to the interval in seconds between progress
+	 *	reports. If 0, progress is not reported.
+	 */
+	static unsigned & interval() {
+		return _interval_;
+	}
+
+	/** \brief Install the handler for `SIGUSR1`, where supported, and
+	 *	start counting for the run summary that it writes.
+	 *
+	 *	Called only by commands that traverse the `dataset`, so that the
+	 *	default disposition of the signal is kept by the others.
+	 */
+	static void arm();
+
+	/// Account a file that is added to the `dataset`.
+	static void add_file(std::string const & filename) {
+		if (_interval_) {
+			count_file(filename);
+		}
+	}
+
+	/// Disown a file that is added to the `dataset` but not to be processed.
+	static void drop_file(std::string const & filename) {
+		if (_interval_) {
+			uncount_file(filename);
+		}
+	}
+
+	/// Start the clock for the traversal of the `dataset`.
+	static void start();
+
+	/// Account a file whose processing is finished.
+	static void file_done(std::string const & filename) {
+		if (_interval_) {
+			done_file(filename);
+		}
+		poll();
+	}
+
+	/** \brief Respond to any pending signal or due progress report.
+	 *
+	 *	Called between input lines. The signal flag and the clock are
+	 *	consulted only once in every `poll_period` calls.
+	 */
+	static void poll() {
+		if ((_armed_ || _interval_) && !(++_polls_ % poll_period)) {
+			service();
+		}
+	}
+
+private:
+
+	/// Type of clock that times the run
+	using clock = std::chrono::steady_clock;
+
+	/// The number of calls to `poll()` per check of the signal and clock.
+	static constexpr unsigned poll_period = 1024;
+
+	/// Add the size of a file to the total bytes to be processed
+	static void count_file(std::string const & filename);
+
+	/// Subtract the size of a file from the total bytes to be processed
+	static void uncount_file(std::string const & filename);
+
+	/// Add the size of a file to the bytes processed
+	static void done_file(std::string const & filename);
+
+	/// Write any pending stats snapshot and any due progress report
+	static void service();
+
+	/// Write a progress report to stderr
+	static void report(clock::time_point now);
+
+	/// Handle `SIGUSR1`
+	static void on_signal(int);
+
+	/// The interval in seconds between progress reports, if any.
+	static unsigned _interval_;
+	/// Is the handler for `SIGUSR1` installed?
+	static bool _armed_;
+	/// The number of calls to `poll()`
+	static unsigned _polls_;
+	/// The number of files processed
+	static unsigned _done_files_;
+	/// The total bytes of the files in the `dataset`
+	static unsigned long long _total_bytes_;
+	/// The cumulative bytes of the files processed
+	static unsigned long long _done_bytes_;
+	/// The time at which traversal of the `dataset` began
+	static clock::time_point _start_;
+	/// The time at which the next progress report is due
+	static clock::time_point _next_;
+};
+
+#endif // EOF
@@ -47,6 +47,11 @@
 #include "citable.h"
 #include "options.h"
 #include "line_despatch.h"
+#include "stats.h"
+#include "trace.h"
+#include "profile.h"
+#include "file_budget.h"
+#include "expansion_cache.h"
 #include <iostream>
 
 using namespace std;
@@ -67,24 +72,28 @@ reference::insert_result
 reference::lookup() {
 	reference_cache::iterator loc = lower_bound();
 	if (reference_cache::at_end(loc) || loc->first != _key) {
+		stats::count_cache_miss();
 		reference_cache::value_type v = digest();
 		if (!_referee->self_referential()) {
 			_referee->make_clean();
 		}
-		return insert_result(reference_cache::insert(v,loc),true);
+		return insert_result(reference_cache::insert(std::move(v),loc),true);
 	}
 	if (_referee->dirty()) {
+		stats::count_cache_invalidation();
 		loc->second = digest().second;
 		if (!_referee->self_referential()) {
 			_referee->make_clean();
 		}
 		return insert_result(loc,true);
 	}
+	stats::count_cache_hit();
 	return insert_result(loc,false);
 }
 
 reference_cache::value_type reference::digest()
 {
+	profile::digest_timer profiling(_referee->id());
 	bool exp = explain();
 	if (exp) {
 		unsigned lineno = line_despatch::cur_line().num();
@@ -109,11 +118,18 @@ reference_cache::value_type reference::digest()
 			resolved.eval().set_insoluble();
 		}
 	}
-	return reference_cache::value_type(_key,resolved);
+	return reference_cache::value_type(_key,std::move(resolved));
 }
 
 reference_cache::entry reference::expand(bool explain)
 {
+	stats::timer timing(stats::phase::expansion);
+	trace::span tracing("expansion");
+	if (tracing) {
+		tracing.name(invocation());
+		tracing.arg("file",io::in_file_name());
+		tracing.arg("line",line_despatch::cur_line().num());
+	}
 	evaluation eval = validate();
 	if (eval.insoluble()) {
 		return reference_cache::entry(invocation(),eval);
@@ -121,16 +137,46 @@ reference_cache::entry reference::expand(bool explain)
 	if (eval.empty()) {
 		return reference_cache::entry(string(),eval);
 	}
-	unique_ptr<expansion_base> pe = expansion_base::factory(explain,*this);
+	bool storable = expansion_cache::on() &&
+		_referee->origin() == symbol::provenance::global;
 	try {
-        pe->expand();
+		file_budget::charge_expansion();
+		if (storable) {
+			expansion_cache::stored const * s =
+				expansion_cache::recall(_key,explain);
+			if (s) {
+				if (explain) {
+					cout << s->_explanation;
+				}
+				for (string const & id : s->_invoked) {
+					symbol::lookup(id)->set_invoked();
+				}
+				return reference_cache::entry(s->_expansion,eval,false,true);
+			}
+		}
+		std::unique_ptr<expansion_cache::recorder> recording(storable ?
+			new expansion_cache::recorder(explain) : nullptr);
+		unique_ptr<expansion_base> pe = expansion_base::factory(explain,*this);
+		try {
+			pe->expand();
+		}
+		catch(expansion_base const & eb) {
+			eval.set_insoluble();
+			return reference_cache::entry(
+				pe->reference::invocation(),eval,false,false);
+		}
+		stats::count_expansion();
+		profile::charge_expansion(_referee->id(),pe->value().size());
+		if (recording) {
+			recording->keep(_key,pe->value());
+		}
+		return reference_cache::entry(pe->take_value(),eval,false,true);
 	}
-	catch(expansion_base const & eb) {
-	    eval.set_insoluble();
-	    return reference_cache::entry(
-                            pe->reference::invocation(),eval,false,false);
+	catch(file_budget::overrun const &) {
+		/* The file has exceeded a budget. Leave the reference unresolved */
+		eval.set_insoluble();
+		return reference_cache::entry(invocation(),eval);
 	}
-	return reference_cache::entry(pe->value(),eval,false,true);
 }
 
 
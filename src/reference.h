@@ -41,6 +41,7 @@
 #include "symbol.h"
 #include "argument_list.h"
 #include "reference_cache.h"
+#include "symbol_index.h"
 #include <string>
 
 
@@ -73,19 +74,21 @@ struct reference
 	: 	_referee(loc),
 		_args(_referee->parameters()),
 		_invoker(invoker),
-		_key(_referee.id() + _args.str()){}
+		_key(key(_referee,_args)){}
 
 
 	/** \brief Construct given a symbol locator `argument_list`
 	 *	and optional parent reference.
+	 *
+	 *	An rvalue `args` is moved into the reference.
 	 */
 	reference(
 		symbol::locator loc,
-		argument_list const & args,
+		argument_list args,
 		reference const * invoker = nullptr)
-	: 	_referee(loc),_args(args),
+	: 	_referee(loc),_args(std::move(args)),
 		_invoker(invoker),
-		_key(_referee.id() + _args.str()){
+		_key(key(_referee,_args)){
 			_referee->set_invoked();
 		}
 
@@ -107,12 +110,24 @@ struct reference
 		chewer<CharSeq> & chew,
 		reference const * invoker = nullptr)
 	: 	_referee(loc),_args(chew),
-		_invoker(invoker),_key(_referee.id() + _args.str()) {
+		_invoker(invoker),_key(key(_referee,_args)) {
         static_assert(traits::is_random_access_char_sequence<CharSeq>::value,
             ">:[");
 		_referee->set_invoked();
 	}
 
+	/// Copy constructor
+	reference(reference const & other) = default;
+
+	/// Move constructor
+	reference(reference && other) = default;
+
+	/// Copy assignment
+	reference & operator=(reference const & other) = default;
+
+	/// Move assignment
+	reference & operator=(reference && other) = default;
+
 	virtual ~reference() = default;
 
 	/** \brief Equality.
@@ -184,6 +199,7 @@ struct reference
 
 	/// Report this reference appropriately.
 	void report() {
+		symbol_index::note(*_referee);
 		if (reportable()) {
 			do_report();
 		}
@@ -208,6 +224,18 @@ protected:
 	void do_report();
 
 
+	/** \brief Compose the cache key of a reference.
+	 *	\param loc Locator of the referenced symbol.
+	 *	\param args The arguments of the reference.
+	 *	\return The symbol's name followed by the argument list.
+	 */
+	static std::string
+	key(symbol::locator const & loc, argument_list const & args) {
+		std::string k(loc.id());
+		args.append_str(k);
+		return k;
+	}
+
 	/// Get a lower bound to this reference in the reference cache.
 	reference_cache::iterator lower_bound() const {
 		return reference_cache::lower_bound(_key);
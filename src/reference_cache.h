@@ -38,8 +38,10 @@
  **************************************************************************/
 
 #include "evaluation.h"
+#include "stats.h"
 #include <string>
 #include <map>
+#include <utility>
 
 /** \file reference_cache.h
  *   This file defines `struct reference_cache`.
@@ -54,18 +56,19 @@ struct reference_cache
 	struct entry
 	{
 		/** Constructor
-		 *  \param expansion The expansion of the reference
+		 *  \param expansion The expansion of the reference. An rvalue
+		 *		is moved into the entry.
 		 *  \param eval The evaluation of the reference
 		 *  \param reported Has the reference been reported?
 		 *  \param complete Is the expansion complete
          *       (or imcomplete because too big)
 		 */
 		entry(
-			std::string const & expansion,
+			std::string expansion,
 			evaluation const & eval,
 			bool reported = false,
 			bool complete = true)
-		: 	_expansion(expansion),_eval(eval),_reported(reported),
+		: 	_expansion(std::move(expansion)),_eval(eval),_reported(reported),
 			_complete(complete){}
 
 		/// Get the expansion of the cached reference
@@ -135,6 +138,15 @@ struct reference_cache
 		return get_map().insert(hint,v);
 	}
 
+	/** \brief Insert a `value_type` into the cache by moving
+	 *  \param v The `value_type` to insert.
+	 *  \param hint A hint-iterator as per `std::map::insert`.
+	 *  \return An iterator to the inserted `value_type`.
+	 */
+	static iterator insert(value_type && v, iterator hint) {
+		return get_map().insert(hint,std::move(v));
+	}
+
 
 	/** \brief Insert an `entry` by key into cache
 	 *  \param key The key of the entry.
@@ -160,6 +172,7 @@ struct reference_cache
 			if (key.find(id) == 0 &&
 				(key.length() == id.length() || key[id.length()] == '(')) {
 				i = get_map().erase(i);
+				stats::count_cache_invalidation();
 			} else {
 				break;
 			}
@@ -171,6 +184,13 @@ struct reference_cache
 		get_map().clear();
 	}
 
+	/** \brief Exchange the contents of the cache with a `map`
+	 *  \param other The `map` to exchange with the cache.
+	 */
+	static void swap(map & other) {
+		get_map().swap(other);
+	}
+
 	/// Say whether an iterator points to the end of the cache.
 	template<class Iter>
 	static bool at_end(Iter i) {
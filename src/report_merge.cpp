@@ -0,0 +1,148 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "report_merge.h"
+#include "options.h"
+#include "diagnostic.h"
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <cstdlib>
+
+/** \file report_merge.cpp
+ *   This file implements `struct report_merge`
+ */
+
+using namespace std;
+
+vector<string> report_merge::_reports_;
+
+void report_merge::add(string const & filename)
+{
+	_reports_.push_back(filename);
+}
+
+void report_merge::add_exit_codes(string const & arg)
+{
+	char const * str = arg.c_str();
+	for (;;) {
+		char *endp;
+		unsigned long code = strtoul(str,&endp,0);
+		if (endp == str || (*endp && *endp != ',') || code > 255) {
+			error_usage() << "Invalid argument for --exit-codes: \""
+				<< arg << '\"' << emit();
+		}
+		diagnostic_base::merge_exitcode(int(code));
+		if (!*endp) {
+			break;
+		}
+		str = endp + 1;
+	}
+}
+
+string report_merge::key(string const & line)
+{
+	static char const * const provenances[] = {
+		": unconfigured", ": global", ": transient"
+	};
+	if (line.empty()) {
+		return line;
+	}
+	if (line[0] == '#') {
+		/* A directive is reported at most once with the same text */
+		size_t end = line.length();
+		if (options::list_location() && line[end - 1] == ')') {
+			size_t loc = line.rfind(": ");
+			if (loc != string::npos) {
+				end = loc;
+			}
+		}
+		return line.substr(0,end);
+	}
+	/* A symbol reference is reported at most once with the same
+		invocation, unless the symbol is redefined in-source, which
+		makes it transient */
+	for (char const * provenance : provenances) {
+		size_t end = line.find(provenance);
+		if (end != string::npos) {
+			return provenance == provenances[2] ?
+				string() : line.substr(0,end);
+		}
+	}
+	return string();
+}
+
+void report_merge::merge()
+{
+	set<string> reported;
+	for (size_t i = 0; i < _reports_.size(); ++i) {
+		ifstream in(_reports_[i].c_str());
+		if (!in.good()) {
+			abend_cant_open_input() << "Can't open " <<
+				_reports_[i] << " for reading" << emit();
+		}
+		set<string> reported_here;
+		unsigned in_options = 0;
+		for (string line; getline(in,line); ) {
+			if (i > 0) {
+				/* Every shard reports references in the options, with
+					the explanations of their expansions */
+				bool options_line = line.length() >= 11 &&
+					line.compare(line.length() - 11,11," in options") == 0;
+				if (options_line) {
+					if (line.compare(0,11,"Expanding \"") == 0) {
+						++in_options;
+					} else if (in_options) {
+						--in_options;
+					}
+				}
+				if (options_line || in_options) {
+					continue;
+				}
+			}
+			if (options::list_only_once()) {
+				string k = key(line);
+				if (!k.empty()) {
+					if (reported.count(k)) {
+						continue;
+					}
+					reported_here.insert(k);
+				}
+			}
+			cout << line << '\n';
+		}
+		reported.insert(reported_here.begin(),reported_here.end());
+	}
+}
+
+// EOF
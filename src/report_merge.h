@@ -0,0 +1,92 @@
+#ifndef REPORT_MERGE_H
+#define REPORT_MERGE_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+
+/** \file report_merge.h
+ *   This file defines `struct report_merge`
+ */
+
+/** \brief `struct report_merge` implements the `merge` command.
+ *
+ *  The `merge` command combines the reports that runs of a listing
+ *	command with `--shard 1/N` through `--shard N/N` write on the
+ *	standard output, giving them in the order of the shards. The
+ *	combined report is written on the standard output, as a single run
+ *	of the listing command would have written it. The exit code is the
+ *	combination of the exit codes of the shard runs, if given.
+ *
+ *	The `--once-only` and `--locate` options must be the same as for the
+ *	shard runs.
+ */
+struct report_merge {
+
+	/** \brief Add a report to be merged.
+	 *	\param filename The name of a file containing the report of a
+	 *		shard run.
+	 */
+	static void add(std::string const & filename);
+
+	/** \brief Add the exit codes of the shard runs.
+	 *	\param arg The argument of the `--exit-codes` option, a
+	 *		comma-punctuated list of exit codes.
+	 */
+	static void add_exit_codes(std::string const & arg);
+
+	/// Get the number of reports to be merged.
+	static size_t reports() {
+		return _reports_.size();
+	}
+
+	/// Write the merged reports on the standard output.
+	static void merge();
+
+private:
+
+	/** \brief Get the key that identifies the item reported by a line
+	 *	for the purpose of `--once-only`.
+	 *	\param line A line of a report.
+	 *	\return The key of the line, or an empty string if the line
+	 *		does not report an item that is subject to `--once-only`.
+	 */
+	static std::string key(std::string const & line);
+
+	/// The names of the report files to be merged.
+	static std::vector<std::string> _reports_;
+};
+
+#endif // EOF
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "shard.h"
+#include "diagnostic.h"
+#include <cstdlib>
+#include <climits>
+
+/** \file shard.cpp
+ *   This file implements `struct shard`
+ */
+
+using namespace std;
+
+unsigned shard::_shard_ = 0;
+unsigned shard::_shards_ = 1;
+unsigned shard::_first_ = 0;
+unsigned shard::_end_ = 0;
+bool shard::_partitioned_ = false;
+
+void shard::set(string const & arg)
+{
+	char const * str = arg.c_str();
+	char *endp;
+	unsigned long i = strtoul(str,&endp,10);
+	unsigned long n = 0;
+	if (endp != str && *endp == '/') {
+		str = endp + 1;
+		n = strtoul(str,&endp,10);
+	}
+	if (endp == str || *endp || !i || i > n || n > UINT_MAX) {
+		error_usage() << "Invalid argument for --shard: \""
+			<< arg << "\". Need I/N, with 0 < I <= N" << emit();
+	}
+	_shard_ = unsigned(i - 1);
+	_shards_ = unsigned(n);
+}
+
+void shard::partition(vector<unsigned long long> const & sizes)
+{
+	/* Each file weighs 1 more than its size, so that empty files
+		are shared out too. A file falls in the shard that contains
+		the midpoint of its weight in the cumulative weight of
+		the files. */
+	unsigned long long total = 0;
+	for (unsigned long long size : sizes) {
+		total += size + 1;
+	}
+	unsigned long long cumulative = 0;
+	_first_ = _end_ = unsigned(sizes.size());
+	for (unsigned i = 0; i < sizes.size(); ++i) {
+		unsigned long long midpoint = 2 * cumulative + sizes[i] + 1;
+		unsigned which = unsigned(midpoint * _shards_ / (2 * total));
+		if (which >= _shard_ && _first_ == sizes.size()) {
+			_first_ = i;
+		}
+		if (which > _shard_) {
+			_end_ = i;
+			break;
+		}
+		cumulative += sizes[i] + 1;
+	}
+	if (_end_ < _first_) {
+		_end_ = _first_;
+	}
+	_partitioned_ = true;
+}
+
+// EOF
@@ -0,0 +1,105 @@
+#ifndef SHARD_H
+#define SHARD_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <vector>
+
+/** \file shard.h
+ *   This file defines `struct shard`
+ */
+
+/** \brief `struct shard` selects a stable subset of the `dataset` for
+ *	processing.
+ *
+ *  With the `--shard I/N` option, the files of the `dataset`, in the
+ *	order of traversal, are partitioned into `N` contiguous ranges of
+ *	roughly equal total size, and only the files of the `I`-th range
+ *	are processed. The partition depends only on the names and sizes of
+ *	the files, so runs of the same command with `--shard 1/N` through
+ *	`--shard N/N` process every file exactly once, in the order of a
+ *	single run, and their reports can be combined by `coan merge`.
+ */
+struct shard {
+
+	/** \brief Specify the shard to be processed.
+	 *	\param arg The argument of the `--shard` option, `I/N`.
+	 */
+	static void set(std::string const & arg);
+
+	/// Say whether the `dataset` is sharded.
+	static bool on() {
+		return _shards_ > 1;
+	}
+
+	/** \brief Partition the `dataset` given the sizes of its files.
+	 *	\param sizes The sizes of the files of the `dataset`, in the
+	 *		order of traversal.
+	 */
+	static void partition(std::vector<unsigned long long> const & sizes);
+
+	/// Say whether the `dataset` has been partitioned.
+	static bool partitioned() {
+		return _partitioned_;
+	}
+
+	/// Get the number of files in the shard.
+	static unsigned files() {
+		return _end_ - _first_;
+	}
+
+	/** \brief Say whether a file is within the shard.
+	 *	\param ordinal The 0-based position of the file in the order
+	 *		of traversal.
+	 */
+	static bool contains(unsigned ordinal) {
+		return ordinal >= _first_ && ordinal < _end_;
+	}
+
+private:
+
+	/// The 0-based index of the shard to be processed.
+	static unsigned _shard_;
+	/// The number of shards.
+	static unsigned _shards_;
+	/// The ordinal of the first file in the shard.
+	static unsigned _first_;
+	/// The ordinal of the first file after the shard.
+	static unsigned _end_;
+	/// Has the `dataset` been partitioned?
+	static bool _partitioned_;
+};
+
+#endif // EOF
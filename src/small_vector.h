@@ -0,0 +1,247 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+/** \file small_vector.h
+ *   This file defines `template struct small_vector<T,N>`
+ */
+
+/** \brief `template struct small_vector<T,N>` is a sequence of `T` that
+ *   keeps up to `N` elements in place and only resorts to the heap when
+ *   it grows beyond `N`.
+ *
+ *  Macro argument and parameter lists are nearly always short, so
+ *  holding them in a `small_vector` spares a heap allocation for
+ *  every list that is built or copied. Only the operations those
+ *  lists need are supported.
+ *
+ *  \tparam T The element type. It must be default-constructible, and not
+ *  `bool`, since `std::vector<bool>` has no contiguous storage.
+ *  \tparam N The number of elements that can be held in place.
+ */
+template<typename T, size_t N>
+struct small_vector {
+
+	/// Type of the elements
+	using value_type = T;
+	/// Type of iterator
+	using iterator = T *;
+	/// Type of const iterator
+	using const_iterator = T const *;
+
+	/// Construct an empty `small_vector`
+	small_vector() = default;
+
+	/// Copy constructor
+	small_vector(small_vector const & other) {
+		assign(other.begin(),other.end());
+	}
+
+	/// Move constructor
+	small_vector(small_vector && other) {
+		take(other);
+	}
+
+	/// Copy assignment
+	small_vector & operator=(small_vector const & other) {
+		if (this != &other) {
+			assign(other.begin(),other.end());
+		}
+		return *this;
+	}
+
+	/// Move assignment
+	small_vector & operator=(small_vector && other) {
+		if (this != &other) {
+			clear();
+			take(other);
+		}
+		return *this;
+	}
+
+	/// Equality
+	bool operator==(small_vector const & other) const {
+		if (_size != other._size) {
+			return false;
+		}
+		for (size_t i = 0; i < _size; ++i) {
+			if (!(data()[i] == other.data()[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// Inequality
+	bool operator!=(small_vector const & other) const {
+		return !(*this == other);
+	}
+
+	/// Get the number of elements
+	size_t size() const {
+		return _size;
+	}
+
+	/// Say whether the `small_vector` is empty
+	bool empty() const {
+		return !_size;
+	}
+
+	/// Say whether the elements have spilled to the heap
+	bool on_heap() const {
+		return _size > N;
+	}
+
+	///@{
+	/// Get a [const] pointer to the first element
+	T * data() {
+		return on_heap() ? _heap.data() : _inline;
+	}
+
+	T const * data() const {
+		return on_heap() ? _heap.data() : _inline;
+	}
+	///@}
+
+	///@{
+	/// Get a [const] iterator to the start of the `small_vector`
+	iterator begin() {
+		return data();
+	}
+
+	const_iterator begin() const {
+		return data();
+	}
+	///@}
+
+	///@{
+	/// Get a [const] iterator to the end of the `small_vector`
+	iterator end() {
+		return data() + _size;
+	}
+
+	const_iterator end() const {
+		return data() + _size;
+	}
+	///@}
+
+	///@{
+	/// Get an un-range-checked [const] reference to the `n`th element
+	T & operator[](size_t n) {
+		return data()[n];
+	}
+
+	T const & operator[](size_t n) const {
+		return data()[n];
+	}
+	///@}
+
+	/// Append an element, moving from it if it is an rvalue
+	template<typename U>
+	void push_back(U && val) {
+		if (_size < N) {
+			_inline[_size] = std::forward<U>(val);
+		} else {
+			if (_size == N) {
+				_heap.reserve(2 * N);
+				for (size_t i = 0; i < N; ++i) {
+					_heap.push_back(std::move(_inline[i]));
+					_inline[i] = T();
+				}
+			}
+			_heap.push_back(std::forward<U>(val));
+		}
+		++_size;
+	}
+
+	/// Remove all elements
+	void clear() {
+		if (on_heap()) {
+			_heap.clear();
+		} else {
+			for (size_t i = 0; i < _size; ++i) {
+				_inline[i] = T();
+			}
+		}
+		_size = 0;
+	}
+
+	/// Replace the contents with `n` copies of `val`
+	void assign(size_t n, T const & val) {
+		clear();
+		for ( ;n; --n) {
+			push_back(val);
+		}
+	}
+
+	/// Replace the contents with the range [`first`,`last`)
+	template<typename InIter>
+	void assign(InIter first, InIter last) {
+		clear();
+		for ( ;first != last; ++first) {
+			push_back(*first);
+		}
+	}
+
+private:
+
+	/// Take over the contents of `other`, leaving it empty
+	void take(small_vector & other) {
+		if (other.on_heap()) {
+			_heap = std::move(other._heap);
+			other._heap.clear();
+		} else {
+			for (size_t i = 0; i < other._size; ++i) {
+				_inline[i] = std::move(other._inline[i]);
+				other._inline[i] = T();
+			}
+		}
+		_size = other._size;
+		other._size = 0;
+	}
+
+	/// In-place storage for up to `N` elements
+	T _inline[N] = {};
+	/// Heap storage for more than `N` elements
+	std::vector<T> _heap;
+	/// The number of elements
+	size_t _size = 0;
+};
+
+#endif //EOF
@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "stats.h"
+#include "symbol.h"
+#include "directive.h"
+#include "platform.h"
+#include <iomanip>
+#ifdef NIX
+#include <sys/resource.h>
+#endif
+
+/** \file stats.cpp
+ *   This file implements `struct stats`
+ */
+
+using namespace std;
+
+bool stats::_counting_ = false;
+stats::phase stats::_phase_ = stats::phase::none;
+stats::clock::time_point stats::_wall_mark_ = stats::clock::now();
+clock_t stats::_cpu_mark_ = std::clock();
+stats::clock::duration stats::_wall_[phases];
+clock_t stats::_cpu_[phases];
+unsigned long stats::_lines_ = 0;
+unsigned long stats::_directives_[COMMANDLINE];
+unsigned long stats::_expansions_ = 0;
+unsigned long stats::_ifs_[2];
+unsigned long stats::_cache_hits_ = 0;
+unsigned long stats::_cache_misses_ = 0;
+unsigned long stats::_cache_invalidations_ = 0;
+#ifdef ALLOC_PROFILE
+unsigned long stats::_allocs_[phases];
+unsigned long long stats::_alloc_bytes_[phases];
+unsigned long stats::_frees_[phases];
+#endif
+
+/// Names of the phases, indexed by `stats::phase`
+static char const * const phase_names[] = {
+	"other", "discovery", "reading", "evaluation", "expansion", "output",
+	"diagnostics"
+};
+
+/// Write one item of the run summary to a stream
+template<typename T>
+static void item(ostream & out, string const & name, T const & value)
+{
+	out << "  " << left << setw(32) << name << right << value << '\n';
+}
+
+void stats::enter(phase p)
+{
+	clock::time_point wall = clock::now();
+	clock_t cpu = std::clock();
+	_wall_[unsigned(_phase_)] += wall - _wall_mark_;
+	_cpu_[unsigned(_phase_)] += cpu - _cpu_mark_;
+	_wall_mark_ = wall;
+	_cpu_mark_ = cpu;
+	_phase_ = p;
+}
+
+unsigned long stats::directives()
+{
+	unsigned long directives = 0;
+	for (unsigned i = 0; i < COMMANDLINE; ++i) {
+		directives += _directives_[i];
+	}
+	return directives;
+}
+
+void stats::report(ostream & out)
+{
+	using secs = chrono::duration<double>;
+	out << options::prog_name() << " stats:\n" << fixed << setprecision(6);
+	if (options::stats()) {
+		enter(_phase_);
+		secs wall_total(0);
+		clock_t cpu_total = 0;
+		for (unsigned j = 1; j <= phases; ++j) {
+			unsigned i = j % phases;
+			secs wall = _wall_[i];
+			string name = string("time.") + phase_names[i];
+			item(out,name + ".wall_s",wall.count());
+			item(out,name + ".cpu_s",double(_cpu_[i]) / CLOCKS_PER_SEC);
+			wall_total += wall;
+			cpu_total += _cpu_[i];
+		}
+		item(out,"time.total.wall_s",wall_total.count());
+		item(out,"time.total.cpu_s",double(cpu_total) / CLOCKS_PER_SEC);
+	}
+#ifdef ALLOC_PROFILE
+	for (unsigned j = 1; j <= phases; ++j) {
+		unsigned i = j % phases;
+		string name = string("allocs.") + phase_names[i];
+		item(out,name + ".count",_allocs_[i]);
+		item(out,name + ".bytes",_alloc_bytes_[i]);
+		item(out,name + ".frees",_frees_[i]);
+	}
+#endif
+	item(out,"lines",_lines_);
+	item(out,"directives",directives());
+	for (unsigned i = 0; i < COMMANDLINE; ++i) {
+		item(out,string("directives.") +
+			directive_base::keyword(directive_type(i)),_directives_[i]);
+	}
+	item(out,"expansions",_expansions_);
+	item(out,"ifs.resolved",_ifs_[1]);
+	item(out,"ifs.unresolved",_ifs_[0]);
+	item(out,"reference_cache.hits",_cache_hits_);
+	item(out,"reference_cache.misses",_cache_misses_);
+	item(out,"reference_cache.invalidations",_cache_invalidations_);
+	item(out,"symbols.global",symbol::count(symbol::provenance::global));
+	item(out,"symbols.transient",
+		symbol::count(symbol::provenance::transient));
+	item(out,"symbols.unconfigured",
+		symbol::count(symbol::provenance::unconfigured));
+#ifdef NIX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF,&usage) == 0) {
+		item(out,"peak_rss_kb",usage.ru_maxrss);
+	} else {
+		item(out,"peak_rss_kb","unknown");
+	}
+#else
+	item(out,"peak_rss_kb","unknown");
+#endif
+	out.unsetf(ios::floatfield);
+}
+
+// EOF
@@ -0,0 +1,264 @@
+#ifndef STATS_H
+#define STATS_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include "configure.h"
+#include "options.h"
+#include "directive_type.h"
+#include "line_type.h"
+#include "prohibit.h"
+#include <chrono>
+#include <ctime>
+#include <ostream>
+
+/** \file stats.h
+ *   This file defines `struct stats`
+ */
+
+/** \brief `struct stats` accumulates the run summary that is reported
+ *	with the `--stats` option.
+ *
+ *  The run is divided into phases and the wall and CPU time of each
+ *	phase is accounted exclusively: a phase that is entered while another
+ *	is in progress suspends the other until it is left. Phases are
+ *	timed only if `--stats` is in force. The event counters are kept only
+ *	if `start_counting()` has been called, which `options::finish()` does
+ *	when `--stats`, `--profile-files` or `--progress` is in force.
+ *	Otherwise each counting function reduces to a test of a flag.
+ *
+ *	If coan is configured with `--enable-alloc-profile`, which defines
+ *	`ALLOC_PROFILE`, the global `operator new` and `operator delete`
+ *	are replaced to charge heap allocations and deallocations to the
+ *	current phase, and the run summary reports them.
+ */
+struct stats {
+
+	/// Symbolic constants denoting the phases of a run.
+	enum class phase {
+		/// Outside any phase
+		none,
+		/// Discovering the input files
+		discovery,
+		/// Reading input lines
+		reading,
+		/// Evaluating directives
+		evaluation,
+		/// Expanding macros
+		expansion,
+		/// Writing output
+		output,
+		/// Composing and issuing diagnostics
+		diagnostics
+	};
+
+	/** \brief `struct stats::timer` accounts the time of its lifetime to
+	 *	a phase.
+	 */
+	struct timer : private no_copy {
+
+		/// Explicitly construct to enter a given `phase`
+		explicit timer(phase p)
+		: _on(options::stats()),_outer(_phase_) {
+			if (_on) {
+				enter(p);
+			}
+		}
+
+		/// Destructor resumes the enclosing `phase`
+		~timer() {
+			if (_on) {
+				enter(_outer);
+			}
+		}
+
+	private:
+
+		/// Is the timer running?
+		bool _on;
+		/// The phase that was current on construction
+		phase _outer;
+	};
+
+	/// Start keeping the event counters.
+	static void start_counting() {
+		_counting_ = true;
+	}
+
+	/// Say whether the event counters are being kept.
+	static bool counting() {
+		return _counting_;
+	}
+
+	/// Count `n` input lines.
+	static void count_lines(unsigned n = 1) {
+		if (_counting_) {
+			_lines_ += n;
+		}
+	}
+
+	/** \brief Count a directive.
+	 *
+	 *	\param type The type of the directive.
+	 *	\param lineval The `line_type` that the directive was evaluated as.
+	 *
+	 *	An `#if`, `#ifdef`, `#ifndef` or `#elif` is also counted as resolved
+	 *	or unresolved.
+	 */
+	static void count_directive(directive_type type, line_type lineval) {
+		if (!_counting_) {
+			return;
+		}
+		++_directives_[type];
+		switch(type) {
+		case HASH_IF:
+		case HASH_IFDEF:
+		case HASH_IFNDEF:
+		case HASH_ELIF:
+			++_ifs_[lineval != LT_IF && lineval != LT_ELIF];
+			break;
+		default:;
+		}
+	}
+
+	/// Count a macro-expansion.
+	static void count_expansion() {
+		if (_counting_) {
+			++_expansions_;
+		}
+	}
+
+	/// Count a reference found in the reference cache.
+	static void count_cache_hit() {
+		if (_counting_) {
+			++_cache_hits_;
+		}
+	}
+
+	/// Count a reference not found in the reference cache.
+	static void count_cache_miss() {
+		if (_counting_) {
+			++_cache_misses_;
+		}
+	}
+
+	/// Count a cached reference invalidated by a change in its symbol.
+	static void count_cache_invalidation() {
+		if (_counting_) {
+			++_cache_invalidations_;
+		}
+	}
+
+#ifdef ALLOC_PROFILE
+	/// Charge a heap allocation of `bytes` bytes to the current phase.
+	static void count_allocation(size_t bytes) {
+		++_allocs_[unsigned(_phase_)];
+		_alloc_bytes_[unsigned(_phase_)] += bytes;
+	}
+
+	/// Charge a heap deallocation to the current phase.
+	static void count_deallocation() {
+		++_frees_[unsigned(_phase_)];
+	}
+#endif
+
+	/// Get the number of input lines read so far.
+	static unsigned long lines() {
+		return _lines_;
+	}
+
+	/// Get the number of directives read so far.
+	static unsigned long directives();
+
+	/// Get the number of macro-expansions so far.
+	static unsigned long expansions() {
+		return _expansions_;
+	}
+
+	/** \brief Write the run summary to a stream.
+	 *
+	 *	The summary may be written at any time. The times of the phases are
+	 *	included only if `--stats` is in force.
+	 */
+	static void report(std::ostream & out);
+
+private:
+
+	/// Type of the clock that measures wall time.
+	using clock = std::chrono::steady_clock;
+
+	/// The number of `phase`s
+	static constexpr unsigned phases = unsigned(phase::diagnostics) + 1;
+
+	/// Close the accounts of the current phase and enter another.
+	static void enter(phase p);
+
+	/// Are the event counters being kept?
+	static bool _counting_;
+	/// The current phase.
+	static phase _phase_;
+	/// The wall time at which the current phase was entered.
+	static clock::time_point _wall_mark_;
+	/// The CPU time at which the current phase was entered.
+	static std::clock_t _cpu_mark_;
+	/// The accumulated wall time of each phase.
+	static clock::duration _wall_[phases];
+	/// The accumulated CPU time of each phase.
+	static std::clock_t _cpu_[phases];
+	/// The number of input lines.
+	static unsigned long _lines_;
+	/// The number of directives of each type.
+	static unsigned long _directives_[COMMANDLINE];
+	/// The number of macro-expansions.
+	static unsigned long _expansions_;
+	/// The numbers of unresolved and resolved `#if`s.
+	static unsigned long _ifs_[2];
+	/// The number of reference cache hits.
+	static unsigned long _cache_hits_;
+	/// The number of reference cache misses.
+	static unsigned long _cache_misses_;
+	/// The number of reference cache invalidations.
+	static unsigned long _cache_invalidations_;
+#ifdef ALLOC_PROFILE
+	/// The number of heap allocations in each phase.
+	static unsigned long _allocs_[phases];
+	/// The number of bytes heap-allocated in each phase.
+	static unsigned long long _alloc_bytes_[phases];
+	/// The number of heap deallocations in each phase.
+	static unsigned long _frees_[phases];
+#endif
+};
+
+#endif // EOF
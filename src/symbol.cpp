@@ -41,6 +41,8 @@
 #include "canonical.h"
 #include "contradiction.h"
 #include "if_control.h"
+#include "profile.h"
+#include "symbol_index.h"
 #include <algorithm>
 #include <cstring>
 #include <cassert>
@@ -59,10 +61,27 @@ symbol::_null_("",symbol(provenance::unconfigured));
 map<string,symbol>
 symbol::_sym_tab_(&symbol::_null_,&symbol::_null_ + 1);
 
-set<string> symbol::_selected_symbols_set_;
+name_trie symbol::_selection_;
 
 int symbol::_current_snapshot_ = 0;
 int symbol::_last_global_snapshot_ = 0;
+unsigned symbol::_table_epoch_ = 0;
+bool symbol::_presubscribed_ = false;
+vector<symbol::locator> * symbol::_invocation_log_ = nullptr;
+
+symbol::configuration::configuration()
+: _table(&symbol::_null_,&symbol::_null_ + 1){}
+
+void symbol::swap(configuration & config)
+{
+	_sym_tab_.swap(config._table);
+	++_table_epoch_;
+	std::swap(_current_snapshot_,config._current_snapshot);
+	std::swap(_last_global_snapshot_,config._last_global_snapshot);
+	reference_cache::swap(config._references);
+	contradiction::swap_last_conflicted_symbol_id(
+		config._last_conflicted_symbol);
+}
 
 int symbol::snapshot_max() const
 {
@@ -107,13 +126,7 @@ void symbol::undef()
 
 bool symbol::selected(string const & name)
 {
-	set<string>::const_iterator lb =
-		_selected_symbols_set_.lower_bound(name);
-	if (lb != _selected_symbols_set_.end() &&
-			(name == *lb || wildcard_match(*lb,name))) {
-		return true;
-	}
-	return lb != _selected_symbols_set_.begin() && wildcard_match(*--lb,name);
+	return _selection_.matches(name);
 }
 
 bool symbol::deselected(string const & id)
@@ -121,22 +134,6 @@ bool symbol::deselected(string const & id)
 	return options::selected_symbols() && !selected(id);
 }
 
-bool symbol::wildcard_match(string const & wildcard, string const & name)
-{
-#if CXX11_HAVE_STRING_BACK
-	if (wildcard.back() != '*') {
-#else
-	if (*(--wildcard.end()) != '*') {
-#endif
-		return false;
-	}
-	size_t min_len = wildcard.length() - 1;
-	if (name.length() < min_len) {
-		return false;
-	}
-	return memcmp(name.data(),wildcard.data(),min_len) == 0;
-}
-
 void symbol::set_selection(char const *optarg)
 {
 	string arg(optarg);
@@ -262,6 +259,16 @@ void symbol::per_file_init()
 	if (count() < size_t(_last_global_snapshot_) + 1) {
 		return;
 	}
+	if (_presubscribed_) {
+		/* The global symbols are just as this would leave them */
+		_presubscribed_ = false;
+		_current_snapshot_ = count();
+		if (options::get_command() == CMD_SYMBOLS &&
+				options::expand_references()) {
+			report_global_config();
+		}
+		return;
+	}
 	// Skip the null symbol
 	auto i = ++_sym_tab_.begin();
 	// Unsubscribe all symbols
@@ -270,6 +277,7 @@ void symbol::per_file_init()
 	}
 
 	// 	Delete all transients
+	++_table_epoch_;
 	for (i = ++_sym_tab_.begin(); i != _sym_tab_.end();) {
 		if (i->second.origin() == provenance::transient) {
 			i = _sym_tab_.erase(i);
@@ -298,6 +306,7 @@ void symbol::per_file_init()
 
 void symbol::report() const
 {
+	symbol_index::note(*this);
 	if (!line_despatch::cur_line().reportable() ||
 			options::get_command() != CMD_SYMBOLS) {
 		return;
@@ -326,6 +335,7 @@ void symbol::report() const
 
 void symbol::make_dirty(pseudo_snapshot n) {
 	char const * action = nullptr;
+	profile::charge_invalidation(id());
 	switch(n) {
 	case pseudo_snapshot::define_in_progress:
 		action = "Defining";
@@ -352,6 +362,19 @@ void symbol::make_dirty(pseudo_snapshot n) {
 	_snapshot = int(n);
 }
 
+void symbol::enter(vector<string> const & ids)
+{
+	symbol_table::iterator where = table().begin();
+	for (string const & id : ids) {
+		while (where != table().end() && where->first < id) {
+			++where;
+		}
+		if (where == table().end() || where->first != id) {
+			insert(id,provenance::unconfigured,where);
+		}
+	}
+}
+
 void symbol::digest_global_define(chewer<string> & chew)
 {
 	string definition;
@@ -372,6 +395,12 @@ void symbol::digest_global_define(chewer<string> & chew)
 		return;
 	}
 	definition = canonical<string>(chew);
+	digest_global_define(params,definition);
+}
+
+void symbol::digest_global_define(formal_parameter_list const & params,
+                                  string const & definition)
+{
 	if (configured()) {
 		/* -D option defining prior global  */
 		if (_defn) { /* symbol is already defined */
@@ -402,6 +431,7 @@ void symbol::digest_global_define(chewer<string> & chew)
 	set_definition(definition);
 	set_parameters(params);
 	_provenance = provenance::global;
+	_presubscribed_ = false;
 }
 
 line_type
@@ -457,14 +487,14 @@ symbol::digest_transient_define(formal_parameter_list const & params,
 				<< "\" has been assumed for the current file" << emit();
 		}
 		define(definition,params);
-		_provenance = provenance::transient;
+		originate(provenance::transient);
 	} else if (!options::no_transients()) {
 		/* 	If we are here the symbol must be unconfigured.
 			If it were configured global then we have already returned.
 			Hence it could only be configured transient, which is not allowed.
 		*/
+		originate(provenance::unconfigured);
 		set_parameters(params);
-		_provenance = provenance::unconfigured;
 	}
 	return LT_DIRECTIVE_KEEP;
 }
@@ -475,6 +505,11 @@ void symbol::digest_global_undef(chewer<string> & chew)
 		error_garbage_arg() << "Garbage in \"#undef " << id() << '\"' << emit();
 		return;
 	}
+	digest_global_undef();
+}
+
+void symbol::digest_global_undef()
+{
 	if (configured()) {
 		if (_defn) { /* symbol is already defined */
 			error_invalid_args() << "\"-U" << id() << parameters().str()
@@ -492,6 +527,7 @@ void symbol::digest_global_undef(chewer<string> & chew)
 	set_pseudo_snapshot(pseudo_snapshot::undef_in_progress);
 	undef();
 	_provenance = provenance::global;
+	_presubscribed_ = false;
 }
 
 line_type
@@ -530,35 +566,48 @@ symbol::digest_transient_undef()
 					 "\" has been assumed for the current file" << emit();
 		}
 		undef();
-		_provenance = provenance::transient;
+		originate(provenance::transient);
 	} else if (!options::no_transients()) {
 		/* 	If we are here the symbol must be unconfigured.
 			If it were configured global then we have already returned.
 			Hence it could only be configured transient, which is not allowed.
 		*/
-		_provenance = provenance::unconfigured;
+		originate(provenance::unconfigured);
 	}
 	return LT_DIRECTIVE_KEEP;
 }
 
 template<class CharSeq>
-symbol::locator symbol::find_any_in(chewer<CharSeq> & chew, size_t & off)
+symbol::locator symbol::find_any_in(
+	chewer<CharSeq> & chew,
+	size_t & off,
+	parameter_substitution::format const * names)
 {
     static_assert(traits::is_random_access_char_sequence<CharSeq>::value,">:[");
 	string id;
 	while((id = identifier::find_any_in(chew,off)),!id.empty()) {
-		locator sloc = lookup(id);
-		if (sloc) {
-			return sloc;
+		symbol * sym = nullptr;
+		auto resolved = names ? names->resolve(id,sym) :
+			parameter_substitution::format::resolution::unlisted;
+		if (resolved == parameter_substitution::format::resolution::found) {
+			return sym->_loc;
+		}
+		if (resolved == parameter_substitution::format::resolution::unlisted) {
+			locator sloc = lookup(id);
+			if (sloc) {
+				return sloc;
+			}
 		}
 	}
 	return locator();
 }
 
 template
-symbol::locator symbol::find_any_in(chewer<string> &, size_t &);
+symbol::locator symbol::find_any_in(chewer<string> &, size_t &,
+	parameter_substitution::format const *);
 template
-symbol::locator symbol::find_any_in(chewer<parse_buffer> &, size_t &);
+symbol::locator symbol::find_any_in(chewer<parse_buffer> &, size_t &,
+	parameter_substitution::format const *);
 
 /// \endcond NO_DOXYGEN
 
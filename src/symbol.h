@@ -41,9 +41,12 @@
 #include "formal_parameter_list.h"
 #include "line_type.h"
 #include "parameter_substitution.h"
+#include "reference_cache.h"
+#include "name_trie.h"
 #include <string>
 #include <set>
 #include <map>
+#include <memory>
 
 
 /** \file symbol.h
@@ -51,14 +54,17 @@
  *	This file defines `struct symbol`
  */
 
-// Forward decl
+// Forward decls
 struct reference;
+struct config_snapshot;
 
 /// `struct symbol` encapsulates a preprocessor symbol's state
 struct symbol
 {
     /// Friendship to `struct reference`
 	friend reference;
+	/// Friendship to `struct config_snapshot`
+	friend config_snapshot;
 
 	/// Symbolic constants denoting the provenance of a symbol.
 	enum class provenance {
@@ -173,6 +179,11 @@ struct symbol
 		return _loc.id();
 	}
 
+	/// Get the symbols that contribute to the definition of the symbol.
+	std::vector<locator> const & contributors() const {
+		return _contributors;
+	}
+
 	/// Get the provenance of the symbol
 	provenance origin() const {
 		return _provenance;
@@ -337,6 +348,18 @@ struct symbol
 	 */
 	void digest_global_define(chewer<std::string> & chew);
 
+	/** \brief Analyse and handle a global definition of this symbol that
+	 *	has already been parsed.
+	 *
+	 *  \param   params The macro parameter list of the symbol.
+	 *  \param	definition	The canonical definition of the symbol.
+	 *
+	 *  The definition is analysed as for a `-D` option with the same
+	 *  parameters and definition.
+	 */
+	void digest_global_define(formal_parameter_list const & params,
+	                          std::string const & definition);
+
 	/** \brief Analyse and handle an in-source `#define` directive for this
 	 *   symbol.
      *
@@ -367,6 +390,9 @@ struct symbol
 	 */
 	void digest_global_undef(chewer<std::string> & chew);
 
+	/// Analyse and handle a global un-define of this symbol, as for `-USYM`.
+	void digest_global_undef();
+
 	/** \brief Analyse and handle an in-source `#undef` directive for this
 	 *   symbol.
      *
@@ -387,6 +413,17 @@ struct symbol
 		return _sym_tab_.size() - 1;
 	}
 
+	/** \brief Enter names in the symbol table.
+	 *
+	 *  \param  ids  The names to be entered, in ascending order without
+	 *  duplicates.
+	 *
+	 *  Each name that is not already in the table is inserted as an
+	 *  unconfigured symbol. The table is traversed once, in step with
+	 *  `ids`, so that each insertion is made at a known position.
+	 */
+	static void enter(std::vector<std::string> const & ids);
+
 	/*! \brief Lookup an identifier in the symbol table.
      *
 	 *  \param  id  The identfier to be sought.
@@ -413,11 +450,24 @@ struct symbol
      *  the `CharSeq` if none.
 	 *	\param off On return, receives the offset in the `CharSeq`
 	 *	of the first known symbol name detected, if any, else is unchanged.
+	 *	\param names Pointer to a substitution format, if any. An
+	 *	identifier that occurs in it is resolved by it, not looked up.
      *  \return The `locator` of the known symbol detected, if any, else the
      *  null `locator`.
      */
 	template<class CharSeq>
-	static locator find_any_in(chewer<CharSeq> & chew, size_t & off);
+	static locator find_any_in(chewer<CharSeq> & chew, size_t & off,
+		parameter_substitution::format const * names = nullptr);
+
+	/** \brief Get a number that changes whenever symbols may have been
+	 *	removed from the operative symbol table.
+	 *
+	 *	A pointer to a symbol obtained when the number had its current value
+	 *	remains valid.
+	 */
+	static unsigned table_epoch() {
+		return _table_epoch_;
+	}
 
 	/** brief Set the list of symbol masks for symbol reporting, as
 	 * specified by the `--select` option.
@@ -432,6 +482,30 @@ struct symbol
 	/// Report the global configuration, according to options.
 	static void report_global_config();
 
+	/// A configuration of symbols that is not operative
+	struct configuration;
+
+	/** \brief Log the symbols that are invoked hereafter.
+	 *	\param log A pointer to the vector in which to log the locators of
+	 *		invoked symbols, or null to stop logging.
+	 *	\return The previous log, if any, else null.
+	 */
+	static std::vector<locator> * log_invocations(std::vector<locator> * log) {
+		std::swap(log,_invocation_log_);
+		return log;
+	}
+
+	/** \brief Exchange the operative configuration of symbols with
+	 *	another one.
+	 *
+	 *	\param config The `configuration` to exchange with the
+	 *		operative one.
+	 *
+	 *	The symbol table, its snapshot numbers, the reference cache
+	 *	and the latest symbol to be contradicted are exchanged.
+	 */
+	static void swap(configuration & config);
+
 private:
 
 	/// Pseudo snapshot numbers for symbols in indeterminate states
@@ -462,6 +536,9 @@ private:
 	/// Mark the symbol as invoked, or not
 	void set_invoked(bool value = true) {
 		_invoked = value;
+		if (value && _invocation_log_) {
+			_invocation_log_->push_back(_loc);
+		}
 	}
 
 	/** \brief Record the symbol's definition as referring to another
@@ -540,13 +617,9 @@ private:
 	 *		already present.
 	 */
 	static bool add_pattern(std::string const & pattern)  {
-		return _selected_symbols_set_.insert(pattern).second;
+		return _selection_.add(pattern);
 	}
 
-	/// Say whether a symbol name matches a *-terminated wildcard prefix
-	static bool
-	wildcard_match(std::string const & wildcard, std::string const & name);
-
 	/// Get a reference to the symbol table
 	static symbol_table & table() {
 		return symbol::_sym_tab_;
@@ -620,14 +693,47 @@ private:
 	static int _current_snapshot_;
 	/// The last snapshot number consumed by the global configuration.
 	static int _last_global_snapshot_;
-	/// The set of symbols selected for reporting, if any
-	static std::set<std::string> _selected_symbols_set_;
+	/// The number of times symbols have left the operative symbol table
+	static unsigned _table_epoch_;
+	/** Are the global symbols already subscribed, as restored from
+	 *	a precompiled configuration?
+	 */
+	static bool _presubscribed_;
+	/// The log of invoked symbols, if any.
+	static std::vector<locator> * _invocation_log_;
+	/// The patterns of symbols selected for reporting, if any
+	static name_trie _selection_;
 	/// The symbol table.
 	static symbol_table _sym_tab_;
 	/// The table entry of the null symbol
 	static table_entry _null_;
 };
 
+/** \brief `struct symbol::configuration` holds a configuration of symbols
+ *	that is not operative.
+ *
+ *	A default-constructed `configuration` holds an empty symbol table.
+ */
+struct symbol::configuration
+{
+	configuration();
+
+private:
+
+	friend symbol;
+
+	/// The symbol table.
+	symbol_table _table;
+	/// The current sequential snapshot number
+	int _current_snapshot = 0;
+	/// The last snapshot number consumed by the global configuration.
+	int _last_global_snapshot = 0;
+	/// The reference cache
+	reference_cache::map _references;
+	/// The latest symbol to be contradicted
+	std::string _last_conflicted_symbol;
+};
+
 inline symbol::locator::locator()
 : _loc(symbol::table().begin()) {}
 
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "symbol_index.h"
+#include "symbol.h"
+#include "options.h"
+#include "filesys.h"
+#include "io.h"
+#include "diagnostic.h"
+#include "contradiction.h"
+#include "version.h"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+
+/** \file symbol_index.cpp
+ *   This file implements `struct symbol_index`
+ */
+
+using namespace std;
+
+string symbol_index::_filename_;
+map<string,symbol_index::entry> symbol_index::_old_;
+map<string,symbol_index::entry> symbol_index::_new_;
+set<string> symbol_index::_changed_;
+set<string> symbol_index::_symbols_;
+bool symbol_index::_recording_ = false;
+
+/// The first line of an index file.
+static char const index_header[] = "coan index 2";
+
+/** \brief Get the symbol configured by a `--define` or `--undef` option.
+ *	\param arg The option as recorded in `options::config_args()`,
+ *		`-DSYM...` or `-USYM...`
+ */
+static string config_id(string const & arg)
+{
+	size_t end = 2;
+	for (	; end < arg.length() &&
+			(isalnum(arg[end]) || arg[end] == '_'); ++end) {}
+	return arg.substr(2,end - 2);
+}
+
+void symbol_index::load()
+{
+	map<string,string> old_config;
+	map<string,string> new_config;
+	unsigned long long old_fingerprint = 0;
+	ifstream in(_filename_.c_str());
+	if (!in.good()) {
+		/* No index yet: every file is processed */
+		return;
+	}
+	string line;
+	bool good = getline(in,line) && line == index_header;
+	entry * last = nullptr;
+	while (good && getline(in,line)) {
+		istringstream fields(line);
+		string tag;
+		fields >> tag;
+		if (tag == "config") {
+			string arg;
+			fields >> arg;
+			good = arg.length() > 2;
+			old_config[config_id(arg)] = arg;
+		} else if (tag == "options") {
+			good = bool(fields >> hex >> old_fingerprint);
+		} else if (tag == "file") {
+			entry e;
+			string name;
+			fields >> e._mtime >> e._size >> hex >> e._hash;
+			good = fields.get() == ' ' && getline(fields,name);
+			last = &(_old_[name] = e);
+		} else if (tag == "symbols" && last) {
+			string id;
+			while (fields >> id) {
+				last->_symbols.insert(id);
+			}
+			last = nullptr;
+		} else {
+			good = false;
+		}
+	}
+	if (!good || last || old_fingerprint != fingerprint()) {
+		if (!good || last) {
+			warning_bad_index() << "Index file \"" << _filename_ <<
+				"\" is not valid and will be rebuilt" << emit();
+		}
+		_old_.clear();
+		return;
+	}
+	for (string const & arg : options::config_args()) {
+		new_config[config_id(arg)] = arg;
+	}
+	for (auto const & config : old_config) {
+		auto match = new_config.find(config.first);
+		if (match == new_config.end() || match->second != config.second) {
+			_changed_.insert(config.first);
+		}
+	}
+	for (auto const & config : new_config) {
+		if (old_config.find(config.first) == old_config.end()) {
+			_changed_.insert(config.first);
+		}
+	}
+}
+
+void symbol_index::save()
+{
+	ofstream out(_filename_.c_str());
+	if (!out.good()) {
+		abend_cant_open_output() << "Can't open " <<
+			_filename_ << " for writing" << emit();
+	}
+	out << index_header << '\n';
+	out << "options " << hex << fingerprint() << dec << '\n';
+	for (string const & arg : options::config_args()) {
+		out << "config " << arg << '\n';
+	}
+	for (auto const & file : _new_) {
+		entry const & e = file.second;
+		out << "file " << e._mtime << ' ' << e._size << ' ' <<
+			hex << e._hash << dec << ' ' << file.first << '\n';
+		out << "symbols";
+		for (string const & id : e._symbols) {
+			out << ' ' << id;
+		}
+		out << '\n';
+	}
+	out.close();
+	if (!out.good()) {
+		abend_cant_write_file() << "Write error on " << _filename_ << emit();
+	}
+}
+
+bool symbol_index::unaffected(string const & filename)
+{
+	auto found = _old_.find(filename);
+	if (found == _old_.end()) {
+		return false;
+	}
+	entry & e = found->second;
+	for (string const & id : _changed_) {
+		if (e._symbols.count(id)) {
+			return false;
+		}
+	}
+	if (!fs::is_file(fs::obj_type(io::spin_filename(filename))) ||
+			fs::file_size(filename) != e._size) {
+		return false;
+	}
+	unsigned long long mtime = fs::modified_time(filename);
+	if (mtime != e._mtime) {
+		/* Touched but maybe not changed */
+		if (hash(filename) != e._hash) {
+			return false;
+		}
+		e._mtime = mtime;
+	}
+	_new_[filename] = e;
+	return true;
+}
+
+void symbol_index::top()
+{
+	_symbols_.clear();
+	_recording_ = on();
+}
+
+void symbol_index::done(string const & filename, bool complete)
+{
+	if (!_recording_) {
+		return;
+	}
+	_recording_ = false;
+	if (!complete) {
+		_new_.erase(filename);
+		return;
+	}
+	entry & e = _new_[filename];
+	e._mtime = fs::modified_time(filename);
+	e._size = fs::file_size(filename);
+	e._hash = hash(filename);
+	e._symbols.swap(_symbols_);
+}
+
+void symbol_index::add(symbol const & sym)
+{
+	if (_symbols_.insert(sym.id()).second) {
+		for (symbol::locator const & contributor : sym.contributors()) {
+			add(*contributor);
+		}
+	}
+}
+
+unsigned long long symbol_index::hash(string const & filename)
+{
+	unsigned long long h = 14695981039346656037ULL;
+	size_t size = 0;
+	char const * data = fs::map_file(filename,size);
+	for (size_t i = 0; i < size; ++i) {
+		h = (h ^ (unsigned char)data[i]) * 1099511628211ULL;
+	}
+	fs::unmap_file(data,size);
+	return h;
+}
+
+unsigned long long symbol_index::fingerprint()
+{
+	unsigned long long h = 14695981039346656037ULL;
+	auto mix = [&h](string const & s) {
+		for (char c : s) {
+			h = (h ^ (unsigned char)c) * 1099511628211ULL;
+		}
+		h = (h ^ 0) * 1099511628211ULL;
+	};
+	mix(version_number());
+	mix(to_string(options::complement()));
+	mix(to_string(options::line_directives()));
+	mix(to_string(options::get_discard_policy()));
+	mix(to_string(contradiction::get_contradiction_policy()));
+	mix(to_string(options::implicit()));
+	mix(to_string(options::no_transients()));
+	mix(to_string(options::eval_wip()));
+	mix(to_string(options::plaintext()));
+	mix(to_string(options::max_expansion()));
+	return h;
+}
+
+// EOF
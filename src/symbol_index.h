@@ -0,0 +1,151 @@
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include <string>
+#include <set>
+#include <map>
+
+/** \file symbol_index.h
+ *   This file defines `struct symbol_index`
+ */
+
+// Forward decl
+struct symbol;
+
+/** \brief `struct symbol_index` maintains a persistent index from the
+ *	files of the `dataset` to the symbols on which they depend.
+ *
+ *  With the `--index FILE` option of the `spin` command, each file that
+ *	is processed without error is recorded in `FILE` with its size,
+ *	modification time and content hash and the symbols it tests or
+ *	defines, including the symbols that contribute to their definitions.
+ *	The `--define` and `--undef` options of the run are recorded too,
+ *	with a hash of the other options that affect the output.
+ *
+ *  A later run with the same index skips, without reading, every file
+ *	that is unchanged since it was recorded, whose spun output still
+ *	exists, and that depends on none of the symbols whose configuration
+ *	differs from the recorded one. If the hash of the other options
+ *	differs, no file is skipped and the index is rebuilt.
+ */
+struct symbol_index {
+
+	/** \brief Specify the index file.
+	 *	\param filename The argument of the `--index` option.
+	 */
+	static void set(std::string const & filename) {
+		_filename_ = filename;
+	}
+
+	/// Say whether an index is maintained.
+	static bool on() {
+		return !_filename_.empty();
+	}
+
+	/** \brief Read the index file, if it exists, and find the symbols
+	 *	whose configuration has changed since it was written.
+	 */
+	static void load();
+
+	/// Write the index file.
+	static void save();
+
+	/** \brief Say whether a file can be skipped because nothing on which
+	 *	its output depends has changed since it was indexed.
+	 *	\param filename The absolute name of the file.
+	 */
+	static bool unaffected(std::string const & filename);
+
+	/// Start recording the symbols of the current file.
+	static void top();
+
+	/** \brief Finish recording the symbols of a file.
+	 *	\param filename The absolute name of the file.
+	 *	\param complete False if processing of the file was abandoned
+	 *		or left directives unresolved, in which case the file is
+	 *		dropped from the index.
+	 */
+	static void done(std::string const & filename, bool complete);
+
+	/** \brief Note a symbol on which the current file depends.
+	 *	\param sym The symbol.
+	 */
+	static void note(symbol const & sym) {
+		if (_recording_) {
+			add(sym);
+		}
+	}
+
+private:
+
+	/// `struct entry` records an indexed file.
+	struct entry {
+		/// The modification time of the file.
+		unsigned long long _mtime = 0;
+		/// The size of the file.
+		unsigned long long _size = 0;
+		/// The FNV-1a hash of the contents of the file.
+		unsigned long long _hash = 0;
+		/// The symbols on which the file depends.
+		std::set<std::string> _symbols;
+	};
+
+	/// Add a symbol and its contributors to the current file's symbols.
+	static void add(symbol const & sym);
+
+	/// Get the FNV-1a hash of the contents of a file.
+	static unsigned long long hash(std::string const & filename);
+
+	/** \brief Get the hash of the options, other than `--define` and
+	 *	`--undef`, that affect the output of a file.
+	 */
+	static unsigned long long fingerprint();
+
+	/// The name of the index file.
+	static std::string _filename_;
+	/// The entries read from the index file.
+	static std::map<std::string,entry> _old_;
+	/// The entries to be written to the index file.
+	static std::map<std::string,entry> _new_;
+	/// The symbols whose configuration has changed.
+	static std::set<std::string> _changed_;
+	/// The symbols of the current file.
+	static std::set<std::string> _symbols_;
+	/// Are we recording the symbols of the current file?
+	static bool _recording_;
+};
+
+#endif // EOF
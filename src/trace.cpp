@@ -0,0 +1,183 @@
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+#include "trace.h"
+#include "diagnostic.h"
+#include "options.h"
+#include <cstdio>
+
+/** \file trace.cpp
+ *   This file implements `struct trace`
+ */
+
+using namespace std;
+
+bool trace::_tracing_ = false;
+ofstream trace::_out_;
+trace::clock::time_point trace::_epoch_;
+unsigned trace::_directive_threshold_ = 100;
+
+/** \brief Get the length of the valid UTF-8 sequence that starts at
+ *	`str[pos]`, or 0 if there is none.
+ */
+static size_t utf8_length(string const & str, size_t pos)
+{
+	unsigned char lead = str[pos];
+	size_t len = lead < 0xc2 ? 0 : lead < 0xe0 ? 2 : lead < 0xf0 ? 3 :
+		lead < 0xf5 ? 4 : 0;
+	if (!len || pos + len > str.length()) {
+		return 0;
+	}
+	for (size_t i = 1; i < len; ++i) {
+		if (((unsigned char)str[pos + i] & 0xc0) != 0x80) {
+			return 0;
+		}
+	}
+	unsigned char next = str[pos + 1];
+	/* Reject overlong forms, surrogates and code points > U+10FFFF */
+	if ((lead == 0xe0 && next < 0xa0) || (lead == 0xed && next > 0x9f) ||
+		(lead == 0xf0 && next < 0x90) || (lead == 0xf4 && next > 0x8f)) {
+		return 0;
+	}
+	return len;
+}
+
+/** \brief Append a string to another as a JSON string.
+ *
+ *	A byte that is not part of a valid UTF-8 sequence, as in a filename
+ *	in a legacy encoding, is escaped as the Latin-1 character it denotes,
+ *	so that the trace is always valid JSON.
+ */
+static void append_json(string & json, string const & str)
+{
+	json += '\"';
+	for (size_t pos = 0; pos < str.length(); ++pos) {
+		char ch = str[pos];
+		switch(ch) {
+		case '\"':
+		case '\\':
+			json += '\\';
+			json += ch;
+			break;
+		case '\n':
+			json += "\\n";
+			break;
+		case '\t':
+			json += "\\t";
+			break;
+		default:
+			if ((unsigned char)ch < ' ') {
+				char esc[8];
+				snprintf(esc,sizeof(esc),"\\u%04x",ch);
+				json += esc;
+			} else if ((unsigned char)ch < 0x80) {
+				json += ch;
+			} else if (size_t len = utf8_length(str,pos)) {
+				json.append(str,pos,len);
+				pos += len - 1;
+			} else {
+				char esc[8];
+				snprintf(esc,sizeof(esc),"\\u%04x",(unsigned char)ch);
+				json += esc;
+			}
+		}
+	}
+	json += '\"';
+}
+
+void trace::span::arg(char const * key, string const & value)
+{
+	if (_args.length()) {
+		_args += ',';
+	}
+	_args += '\"';
+	_args += key;
+	_args += "\":";
+	append_json(_args,value);
+}
+
+void trace::span::arg(char const * key, unsigned long value)
+{
+	if (_args.length()) {
+		_args += ',';
+	}
+	_args += '\"';
+	_args += key;
+	_args += "\":";
+	_args += to_string(value);
+}
+
+void trace::span::end()
+{
+	using usecs = chrono::duration<double,micro>;
+	clock::time_point now = clock::now();
+	usecs dur = now - _start;
+	if (dur.count() < _threshold) {
+		return;
+	}
+	usecs ts = _start - _epoch_;
+	string name;
+	append_json(name,_name);
+	_out_ << ",\n{\"name\":" << name << ",\"cat\":\"" << _category <<
+		"\",\"ph\":\"X\",\"ts\":" << ts.count() << ",\"dur\":" <<
+		dur.count() << ",\"pid\":1,\"tid\":1,\"args\":{" << _args << "}}";
+}
+
+void trace::open(string const & filename)
+{
+	_out_.open(filename.c_str(),ios_base::out | ios_base::trunc);
+	if (!_out_.is_open()) {
+		abend_cant_open_output() << "Can't open " <<
+			filename << " for writing" << emit();
+	}
+	_out_ << fixed;
+	_out_.precision(3);
+	_out_ << "{\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+		"\"args\":{\"name\":\"" << options::prog_name() << "\"}},\n"
+		"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+		"\"args\":{\"name\":\"main\"}}";
+	_epoch_ = clock::now();
+	_tracing_ = true;
+}
+
+void trace::close()
+{
+	if (_tracing_) {
+		_tracing_ = false;
+		_out_ << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		_out_.close();
+	}
+}
+
+// EOF
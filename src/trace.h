@@ -0,0 +1,152 @@
+#ifndef TRACE_H
+#define TRACE_H
+#pragma once
+/***************************************************************************
+ *   Copyright (C) 2007-2013 Mike Kinghan, imk@burroingroingjoing.com      *
+ *   All rights reserved.                                                  *
+ *                                                                         *
+ *   Redistribution and use in source and binary forms, with or without    *
+ *   modification, are permitted provided that the following conditions    *
+ *   are met:                                                              *
+ *                                                                         *
+ *   Redistributions of source code must retain the above copyright        *
+ *   notice, this list of conditions and the following disclaimer.         *
+ *                                                                         *
+ *   Redistributions in binary form must reproduce the above copyright     *
+ *   notice, this list of conditions and the following disclaimer in the   *
+ *   documentation and/or other materials provided with the distribution.  *
+ *                                                                         *
+ *   Neither the name of Mike Kinghan nor the names of its contributors    *
+ *   may be used to endorse or promote products derived from this software *
+ *   without specific prior written permission.                            *
+ *                                                                         *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS   *
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT     *
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF  MERCHANTABILITY AND FITNESS    *
+ *   FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE        *
+ *   COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,   *
+ *   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,  *
+ *   BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS *
+ *   OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    *
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,*
+ *   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF *
+ *   THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH  *
+ *   DAMAGE.                                                               *
+ *                                                                         *
+ **************************************************************************/
+
+#include "prohibit.h"
+#include <string>
+#include <chrono>
+#include <fstream>
+
+/** \file trace.h
+ *   This file defines `struct trace`
+ */
+
+/** \brief `struct trace` writes a timeline of the run as a Chrome
+ *	trace-event file, if the `--trace` option is given.
+ *
+ *  The file is JSON in the Trace Event Format, which can be loaded
+ *	by `chrome://tracing` or by Perfetto. Each span of interest is
+ *	written as a complete ("X") event when it ends.
+ */
+struct trace {
+
+	/** \brief `struct trace::span` writes a trace event for its lifetime.
+	 *
+	 *	A span does nothing unless tracing is in force. Its name and
+	 *	arguments can then be given after construction, so that
+	 *	they need not be computed when not tracing.
+	 */
+	struct span : private no_copy {
+
+		/** \brief Explicitly construct given a category and a threshold.
+		 *
+		 *	\param category The category of the event.
+		 *	\param threshold The event is written only if the span
+		 *		lasts at least this many microseconds.
+		 */
+		explicit span(char const * category, unsigned threshold = 0)
+		: _on(_tracing_) {
+			if (_on) {
+				_category = category;
+				_threshold = threshold;
+				_start = clock::now();
+			}
+		}
+
+		/// Destructor writes the event, if it is due.
+		~span() {
+			if (_on) {
+				end();
+			}
+		}
+
+		/// Say whether the span will be traced.
+		explicit operator bool() const {
+			return _on;
+		}
+
+		/// Set the name of the event.
+		void name(std::string const & name) {
+			_name = name;
+		}
+
+		/// Add a string argument to the event.
+		void arg(char const * key, std::string const & value);
+
+		/// Add an integer argument to the event.
+		void arg(char const * key, unsigned long value);
+
+	private:
+
+		/// Write the event, if it is due.
+		void end();
+
+		/// Is the span being traced?
+		bool _on;
+		/// The category of the event.
+		char const * _category;
+		/// The least duration in microseconds of an event to be written.
+		unsigned _threshold;
+		/// The time at which the span began.
+		std::chrono::steady_clock::time_point _start;
+		/// The name of the event.
+		std::string _name;
+		/// The arguments of the event, as JSON members.
+		std::string _args;
+	};
+
+	/** \brief Begin writing a trace file.
+	 *
+	 *	\param filename The name of the trace file.
+	 */
+	static void open(std::string const & filename);
+
+	/// Finish writing the trace file, if any.
+	static void close();
+
+	/** \brief Get a reference to the least duration in microseconds
+	 *	of a directive evaluation that is traced.
+	 */
+	static unsigned & directive_threshold() {
+		return _directive_threshold_;
+	}
+
+private:
+
+	/// Type of the clock that times events.
+	using clock = std::chrono::steady_clock;
+
+	/// Are we tracing?
+	static bool _tracing_;
+	/// The trace file.
+	static std::ofstream _out_;
+	/// The time at which tracing began.
+	static clock::time_point _epoch_;
+	/// The least duration of a traced directive evaluation.
+	static unsigned _directive_threshold_;
+};
+
+#endif // EOF
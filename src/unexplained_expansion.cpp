@@ -35,6 +35,8 @@
  **************************************************************************/
 #include "unexplained_expansion.h"
 #include "diagnostic.h"
+#include "file_budget.h"
+#include "profile.h"
 
 /** \file unexplained_expansion.cpp
  *   This file implements `struct unexplained_expansion`.
@@ -65,7 +67,7 @@ unsigned unexplained_expansion::expand()
 		_value = callee()->format()->str();
 		++edits;
 	}
-	return edits += expand(_value);
+	return nothing_to_rescan() ? edits : edits += expand(_value);
 }
 
 unsigned unexplained_expansion::expand(string & str)
@@ -73,15 +75,19 @@ unsigned unexplained_expansion::expand(string & str)
 	unsigned edits = 0;
 	symbol::locator sym;
 	size_t off;
+	auto names = callee()->format();
 	chewer<string> chew(chew_mode::plaintext,str);
-	for (	;(sym = symbol::find_any_in(chew,off)),sym; chew.sync()) {
+	for (	;(sym = symbol::find_any_in(chew,off,names.get())),sym;
+			chew.sync()) {
 		reference ref(sym,chew,this);
 		if (!sym->configured() && !sym->in_progress()) {
 			chew = off + sym->id().length();
 			continue;
 		}
-		unexplained_expansion e(ref);
+		file_budget::charge_expansion();
+		unexplained_expansion e(std::move(ref));
 		try {
+			profile::digest_timer profiling(sym->id());
             if (!e.expand()) {
                 continue;
             }
@@ -93,6 +99,7 @@ unsigned unexplained_expansion::expand(string & str)
                 << max_expansion_size() << " bytes" << emit();
             throw_self();
 		}
+		profile::charge_expansion(sym->id(),e.value().size());
 		size_t len = size_t(chew) - off;
 		if (len && str.compare(off,len,e.value()) == 0) {
 			continue;
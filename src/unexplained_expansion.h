@@ -53,6 +53,10 @@ struct unexplained_expansion : expansion_base
 	explicit unexplained_expansion(reference const & ref)
 	: expansion_base(ref){};
 
+	/// Construct from a reference that is moved
+	explicit unexplained_expansion(reference && ref)
+	: expansion_base(std::move(ref)){};
+
 	/** \brief Perform the unexplained expansion of the reference.
      *  \return The number of edits applied.
 	 */
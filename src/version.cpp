@@ -41,7 +41,7 @@
 #include <cstdlib>
 
 /** \file version.cpp
- *   This file implements free function `version`
+ *   This file implements free functions `version` and `version_number`
  */
 
 /// \cond NO_DOXYGEN
@@ -63,6 +63,11 @@ void version()
 	exit(EXIT_SUCCESS);
 }
 
+char const * version_number()
+{
+	return PACKAGE_VERSION;
+}
+
 /// \endcond NO_DOXYGEN
 
 // EOF
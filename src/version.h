@@ -38,10 +38,13 @@
  **************************************************************************/
 
 /** \file version.h
- *   This file defines free function `version`
+ *   This file defines free functions `version` and `version_number`
  */
 
 ///	Write version information about the program on `cout`.
 void version();
 
+/// Get the version number of the program.
+char const * version_number();
+
 #endif // EOF
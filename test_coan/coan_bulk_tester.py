@@ -303,6 +303,21 @@ check_test_result();
 progress('*** Bulk Test 4: to process {0} files ***'.\
 	format(num_infiles))
 update_test_size_file(num_infiles)
+# Run coan as per the 3rd test, but this time read the
+# file and directory names from stdin delimited by NUL.
+restore_all_backed_up_files()
+write_list_to_file([ name.rstrip('\n') + '\0' for name in infiles_list ],
+	infiles_file)
+cmd = '{0} source {1} --verbose --recurse --null '\
+	'--filter cpp,h --backup \"~\"'.\
+	format(executable,' '.join(undefs_list))
+run(cmd,None,stderr_file,infiles_file)
+progress("*** Done ***");
+check_test_result();
+
+progress('*** Bulk Test 5: to process {0} files ***'.\
+	format(num_infiles))
+update_test_size_file(num_infiles)
 # Run coan with --recurse on the scrap tree again, this time
 # reading all the --undef options of test 2 from a file.
 restore_all_backed_up_files()
@@ -315,7 +330,7 @@ run(cmd,None,stderr_file);
 progress("*** Done ***");
 check_test_result();
 
-progress('*** Bulk Test 5: to process {0} files ***'.\
+progress('*** Bulk Test 6: to process {0} files ***'.\
 	format(num_infiles))
 update_test_size_file(num_infiles)
 # Sabotage many source files in the scrap tree by deleting
@@ -0,0 +1,361 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, argparse, os, random, shutil, time, json, atexit, subprocess
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_corpus_bench')
+
+commands = ['source','spin','symbols','includes','defs','pragmas',
+	'errors','lines','directives']
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Measure coan\'s end-to-end throughput. '
+	'A reproducible corpus of C source files is generated from SEED '
+	'in the shape specified, then each coan command is run over '
+	'the corpus and its throughput, peak memory and the time spent in '
+	'each phase of processing, as reported by --stats, are reported.',
+	epilog='The same SEED and shape always generate the same corpus, '
+		'so results are comparable between builds of coan. Give --coan '
+		'more than once to compare builds in one run.')
+
+parser.add_argument('-v', '--verbosity', default='info', metavar='LEVEL',
+    help='Display diagnostics with severity >= LEVEL,' +
+    ' where LEVEL = \'progress\', \'info\', \'warning\', \'error\' or' +
+    ' \'fatal\'. Default = \'info\'.')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('--coan', metavar='EXE', action='append',
+    help='Benchmark the coan executable EXE. May be repeated. '
+		'Default: coan in EXECDIR')
+
+parser.add_argument('-s', '--seed', metavar='SEED',type=int,
+	default=987654321,
+    help='Seed the pseudo random number generator with the number SEED.'
+    ' Default 987654321')
+
+parser.add_argument('-f', '--files', metavar='NFILES', type=int, default=200,
+    help='Generate NFILES source files. Default 200')
+
+parser.add_argument('-l', '--lines', metavar='NLINES', type=int, default=400,
+    help='Generate NLINES lines per file. Default 400')
+
+parser.add_argument('--density', metavar='FRACTION', type=float,
+	default=0.25,
+    help='FRACTION of the lines are directives. Default 0.25')
+
+parser.add_argument('--macro-depth', metavar='DEPTH', type=int, default=4,
+    help='Each file defines chains of macros DEPTH deep. Default 4')
+
+parser.add_argument('--symbols', metavar='NSYMS', type=int, default=64,
+    help='NSYMS symbols are configured with -D or -U. Default 64')
+
+parser.add_argument('-c', '--commands', metavar='CMDS',
+	default=','.join(commands),
+    help='Run the comma-separated coan commands CMDS. Default \"' +
+		','.join(commands) + '\"')
+
+parser.add_argument('-r', '--repeat', metavar='N', type=int, default=3,
+    help='Time the fastest of N runs of each command. Default 3')
+
+parser.add_argument('-o', '--output', metavar='JSONFILE',
+    help='Also write the results as JSON to JSONFILE')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the corpus at exit')
+
+args = vars(parser.parse_args())
+set_verbosity(args['verbosity'])
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+
+executables = args['coan']
+if not executables:
+	executables = [os.path.join(execdir,'coan.exe') if windows() \
+		else os.path.join(execdir,'coan')]
+for exe in executables:
+	if not is_exe(exe):
+		bail('*** ' + exe + ' is not an executable')
+
+run_commands = args['commands'].split(',')
+for cmd in run_commands:
+	if cmd not in commands:
+		bail('*** Unsupported command \"' + cmd + '\"')
+
+rand = random.Random(args['seed'])
+corpus = os.path.join(pkgdir,'test_coan','bench_corpus')
+workdir = os.path.join(pkgdir,'test_coan','bench_work')
+spindir = os.path.join(pkgdir,'test_coan','bench_spin')
+stats_file = os.path.join(pkgdir,'test_coan','bench_stats.txt')
+phases = ['discovery','reading','evaluation','expansion','output',
+	'diagnostics','other']
+
+def cleanup():
+	file_del(stats_file)
+	if not args['keep']:
+		for d in (corpus,workdir,spindir):
+			if os.path.exists(d):
+				del_tree(d)
+
+def config_symbol(i):
+	''' Return the name of the ith configured symbol '''
+	return 'CFG_' + str(i)
+
+def gen_config(nsyms):
+	''' Return the list of -D and -U options configuring `nsyms` symbols '''
+	options = []
+	for i in range(0,nsyms):
+		if rand.random() < 0.6:
+			options.append('-D' + config_symbol(i) + '=' +
+				str(rand.randint(0,9)))
+		else:
+			options.append('-U' + config_symbol(i))
+	return options
+
+def gen_file(fileno, nlines, density, depth, nsyms):
+	'''
+	Return the lines of a source file that #defines chains of
+	macros `depth` deep and then uses them, and the configured
+	symbols, in directives and code.
+	'''
+	lines = ['/* Generated by ' + get_prog() + ' */']
+	macros = []
+	for chain in range(0,2):
+		prev = None
+		for level in range(0,depth):
+			name = 'M{0}_{1}_{2}'.format(fileno,chain,level)
+			if prev:
+				lines.append('#define {0}(x) ({1}(x) + {2})'.format(
+					name,prev,rand_symbol(nsyms)))
+			else:
+				lines.append('#define {0}(x) (x)'.format(name))
+			prev = name
+		macros.append(prev)
+	open_ifs = 0
+	while len(lines) < nlines - open_ifs:
+		if rand.random() >= density:
+			lines.append(gen_code(macros,nsyms))
+			continue
+		choice = rand.random()
+		if choice < 0.35 or open_ifs == 0 and choice < 0.7:
+			lines.append(gen_if(macros,nsyms))
+			open_ifs += 1
+		elif choice < 0.5:
+			lines.append('#elif ' + gen_condition(macros,nsyms))
+		elif choice < 0.6:
+			lines.append('#else')
+			lines.append(gen_code(macros,nsyms))
+			lines.append('#endif')
+			open_ifs -= 1
+		elif choice < 0.7:
+			lines.append('#endif')
+			open_ifs -= 1
+		elif choice < 0.8:
+			lines.append('#include "hdr{0}.h"'.format(rand.randint(0,99)))
+		elif choice < 0.9:
+			lines.append('#define L{0}_{1} {2}'.format(
+				fileno,len(lines),rand_symbol(nsyms)))
+		elif choice < 0.95:
+			lines.append('#undef ' + rand_symbol(nsyms))
+		else:
+			lines.append('#pragma pack({0})'.format(2 ** rand.randint(0,3)))
+	lines += ['#endif'] * open_ifs
+	return lines
+
+def rand_symbol(nsyms):
+	''' Return a configured symbol or, 1 time in 4, an unconfigured one '''
+	if nsyms and rand.random() < 0.75:
+		return config_symbol(rand.randint(0,nsyms - 1))
+	return 'UNCFG_' + str(rand.randint(0,99))
+
+def gen_condition(macros,nsyms):
+	''' Return a random #if condition '''
+	choice = rand.random()
+	if choice < 0.3:
+		return 'defined({0}) && {1} > {2}'.format(
+			rand_symbol(nsyms),rand_symbol(nsyms),rand.randint(0,9))
+	if choice < 0.6:
+		return '{0}({1}) == {2}'.format(
+			rand.choice(macros),rand_symbol(nsyms),rand.randint(0,20))
+	return '!defined({0}) || {1}'.format(
+		rand_symbol(nsyms),rand_symbol(nsyms))
+
+def gen_if(macros,nsyms):
+	''' Return a random #if, #ifdef or #ifndef '''
+	choice = rand.random()
+	if choice < 0.2:
+		return '#ifdef ' + rand_symbol(nsyms)
+	if choice < 0.4:
+		return '#ifndef ' + rand_symbol(nsyms)
+	return '#if ' + gen_condition(macros,nsyms)
+
+def gen_code(macros,nsyms):
+	''' Return a random line of code '''
+	choice = rand.random()
+	if choice < 0.4:
+		return '\tv{0} = {1}({2}) + {3}; /* use */'.format(
+			rand.randint(0,9),rand.choice(macros),rand.randint(0,99),
+			rand_symbol(nsyms))
+	if choice < 0.7:
+		return '\tcall(\"text {0}\", \'c\', {1});'.format(
+			rand.randint(0,999),rand_symbol(nsyms))
+	if choice < 0.85:
+		return '// comment {0}'.format(rand.randint(0,999))
+	return ''
+
+def gen_corpus():
+	'''
+	Generate the corpus in directories of at most 20 files.
+	Return the total number of lines.
+	'''
+	if os.path.exists(corpus):
+		del_tree(corpus)
+	total_lines = 0
+	for fileno in range(0,args['files']):
+		dirname = os.path.join(corpus,'d' + str(fileno // 20))
+		if fileno % 20 == 0:
+			make_path(dirname)
+		lines = gen_file(fileno,args['lines'],args['density'],
+			args['macro_depth'],args['symbols'])
+		total_lines += len(lines)
+		fh = fopen(os.path.join(dirname,'f{0}.c'.format(fileno)),'w')
+		fh.write('\n'.join(lines) + '\n')
+		fh.close()
+	return total_lines
+
+def get_phases(text):
+	'''
+	Return a dictionary of the wall seconds of each phase from the
+	--stats summary in `text`, or None if there is no summary.
+	'''
+	times = {}
+	for line in text.splitlines():
+		fields = line.split()
+		if len(fields) == 2 and fields[0].startswith('time.') and \
+				fields[0].endswith('.wall_s'):
+			times[fields[0][len('time.'):-len('.wall_s')]] = float(fields[1])
+	if not all(phase in times for phase in phases):
+		return None
+	return dict((phase,times[phase]) for phase in phases)
+
+def run_coan(exe, cmd, config):
+	'''
+	Run `exe` with command `cmd` over the corpus, configured by `config`.
+	Return a tuple of wall seconds, cpu seconds, peak RSS in KB and a
+	dictionary of the wall seconds of each phase.
+	'''
+	argv = [exe,cmd,'--recurse','--filter','c','--gag','info','--stats']
+	if cmd == 'source':
+		# source --replace alters files, so it runs on a copy
+		if os.path.exists(workdir):
+			del_tree(workdir)
+		shutil.copytree(corpus,workdir)
+		argv.append('--replace')
+		argv.append(workdir)
+	elif cmd == 'spin':
+		# spin outputs to a scratch directory, emptied for each run
+		if os.path.exists(spindir):
+			del_tree(spindir)
+		argv += ['--dir',spindir,'--prefix',corpus,corpus]
+	else:
+		argv.append(corpus)
+	argv += config
+	devnull = open(os.devnull,'w')
+	stderr_fh = fopen(stats_file,'w')
+	start = time.time()
+	# Hold the Popen object until the child is reaped. A discarded one
+	# is queued for reaping by subprocess itself, and wait4 would fail.
+	proc = subprocess.Popen(argv,stdout=devnull,stderr=stderr_fh)
+	(pid,status,usage) = os.wait4(proc.pid,0)
+	proc.returncode = -os.WTERMSIG(status) if os.WIFSIGNALED(status) \
+		else os.WEXITSTATUS(status)
+	wall = time.time() - start
+	devnull.close()
+	stderr_fh.close()
+	if os.WIFSIGNALED(status):
+		bail('*** \"' + ' '.join(argv[:2]) + '\" killed by signal ' +
+			str(os.WTERMSIG(status)))
+	# Exit code bits 4 and 8 mean errors and abends. A run with either
+	# has not processed the whole corpus and its timing is not valid.
+	rc = os.WEXITSTATUS(status)
+	stderr_text = slurp_file(stats_file)
+	if rc & 12:
+		bail('*** \"' + ' '.join(argv[:2]) + '\" failed with exit code ' +
+			str(rc) + ':\n' + '\n'.join(stderr_text.splitlines()[-5:]))
+	times = get_phases(stderr_text)
+	if not times:
+		bail('*** \"' + ' '.join(argv[:2]) + '\" wrote no --stats summary')
+	return (wall,usage.ru_utime + usage.ru_stime,usage.ru_maxrss,times)
+
+def benchmark():
+	start = time.time()
+	total_lines = gen_corpus()
+	gen_secs = time.time() - start
+	nfiles = args['files']
+	info('Generated {0} files, {1} lines in {2:.2f}s'.format(
+		nfiles,total_lines,gen_secs))
+	config = gen_config(args['symbols'])
+	results = {
+		'seed' : args['seed'], 'files' : nfiles, 'lines' : total_lines,
+		'density' : args['density'], 'macro_depth' : args['macro_depth'],
+		'symbols' : args['symbols'], 'generate_secs' : gen_secs,
+		'runs' : [] }
+	sys.stdout.write('{0:<12} {1:<32} {2:>9} {3:>9} {4:>12} {5:>10} {6:>10}\n'
+		.format('command','coan','wall s','cpu s','lines/s','files/s',
+			'peak KB'))
+	for cmd in run_commands:
+		for exe in executables:
+			best = None
+			for i in range(0,args['repeat']):
+				progress('Running ' + exe + ' ' + cmd)
+				timing = run_coan(exe,cmd,config)
+				if not best or timing[0] < best[0]:
+					best = timing
+			(wall,cpu,rss,times) = best
+			wall = max(wall,1e-6)
+			run = {
+				'command' : cmd, 'coan' : exe, 'wall_secs' : wall,
+				'cpu_secs' : cpu, 'lines_per_sec' : total_lines / wall,
+				'files_per_sec' : nfiles / wall, 'peak_rss_kb' : rss,
+				'phase_wall_secs' : times }
+			results['runs'].append(run)
+			sys.stdout.write(
+				'{0:<12} {1:<32} {2:>9.3f} {3:>9.3f} {4:>12.0f} {5:>10.1f} '
+				'{6:>10}\n'.format(cmd,exe[-32:],wall,cpu,
+					run['lines_per_sec'],run['files_per_sec'],rss))
+	sys.stdout.write('\nWall seconds per phase:\n')
+	sys.stdout.write('{0:<12} {1:<32}'.format('command','coan') +
+		''.join(' {0:>11}'.format(phase) for phase in phases) + '\n')
+	for run in results['runs']:
+		sys.stdout.write('{0:<12} {1:<32}'.format(
+			run['command'],run['coan'][-32:]) +
+			''.join(' {0:>11.3f}'.format(run['phase_wall_secs'][phase])
+				for phase in phases) + '\n')
+	if args['output']:
+		fh = fopen(args['output'],'w')
+		json.dump(results,fh,indent=2,sort_keys=True)
+		fh.write('\n')
+		fh.close()
+
+atexit.register(cleanup)
+benchmark()
+sys.exit(0)
@@ -0,0 +1,97 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, os, atexit, argparse
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_exclude_tester')
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Verify that the reports of listing commands run with '
+		'--exclude and --exclude-dir are identical with the report of a run '
+		'that never named the excluded files')
+
+parser.add_argument('-v', '--verbosity', metavar='LEVEL',
+	default='progress',
+    help='Display diagnostics with severity >= LEVEL, where '
+    	'LEVEL = \'progress\', \'info\', \'warning\', \'error\' or '
+    	'\'fatal\'. Default = \'progress\'')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',
+	default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the report files at exit')
+
+args = vars(parser.parse_args())
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+set_verbosity(args['verbosity'])
+do_metrics()
+
+failures = 0
+testno = 0
+report_files = []
+keep = args['keep']
+coan = os.path.join(execdir,'coan')
+inputs = os.path.join(pkgdir,'src') + ' ' + \
+	os.path.join(pkgdir,'test_coan','test_cases')
+
+def exithandler():
+	''' atexit() cleanup '''
+	if not keep and not failures:
+		for file in report_files:
+			file_del(file)
+
+def report_file(name):
+	''' Return the name of a report file to be deleted at exit '''
+	report_files.append(name)
+	return name
+
+def do_test(cmd):
+	''' Run the listing command `cmd` over the src directory alone and
+	then over all the inputs with the test_cases directory and the header
+	files excluded, and compare the report and exit code of the pruned run
+	with those of the run that never named the excluded files '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Exclusion test {0}: \"{1}\" ***'.format(testno,cmd))
+	config = ' -DFOO=1 -UBAR --recurse --keepgoing --filter c,cpp,h '
+	single = report_file('exclude.unpruned.txt')
+	rc = run(coan + ' ' + cmd + config + '--filter c,cpp ' +
+		os.path.join(pkgdir,'src'),single,os.devnull)
+	pruned = report_file('exclude.pruned.txt')
+	# The pattern is quoted so that no shell can expand it
+	pruned_rc = run(coan + ' ' + cmd + config +
+		'--exclude-dir test_cases --exclude \'*.h\' ' + inputs,pruned,os.devnull)
+	if not same_run(pruned_rc,pruned,rc,single,'Pruned','unpruned'):
+		failures += 1
+
+atexit.register(exithandler)
+
+do_test('symbols --once-per-file --locate')
+do_test('includes --once-only --locate')
+
+msg = '{0} out of {1} tests failed'.format(failures,testno)
+info(msg)
+
+finis(failures)
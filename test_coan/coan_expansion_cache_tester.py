@@ -0,0 +1,98 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, os, atexit, argparse
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_expansion_cache_tester')
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Verify that the reports of listing commands run with '
+		'--expansion-cache are identical with the report of an uncached run')
+
+parser.add_argument('-v', '--verbosity', metavar='LEVEL',
+	default='progress',
+    help='Display diagnostics with severity >= LEVEL, where '
+    	'LEVEL = \'progress\', \'info\', \'warning\', \'error\' or '
+    	'\'fatal\'. Default = \'progress\'')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',
+	default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the report files at exit')
+
+args = vars(parser.parse_args())
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+set_verbosity(args['verbosity'])
+do_metrics()
+
+failures = 0
+testno = 0
+report_files = []
+keep = args['keep']
+coan = os.path.join(execdir,'coan')
+inputs = os.path.join(pkgdir,'src') + ' ' + \
+	os.path.join(pkgdir,'test_coan','test_cases')
+
+def exithandler():
+	''' atexit() cleanup '''
+	if not keep and not failures:
+		for file in report_files:
+			file_del(file)
+
+def report_file(name):
+	''' Return the name of a report file to be deleted at exit '''
+	report_files.append(name)
+	return name
+
+def do_test(cmd):
+	''' Run the listing command `cmd` once over the inputs and then
+	twice with --expansion-cache, so that the second cached run recalls
+	the expansions stored by the first, and compare the cached reports and
+	exit codes with those of the uncached run '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Expansion cache test {0}: \"{1}\" ***'.format(testno,cmd))
+	config = ' -DFOO=1 -DBAR=FOO+2 -DCAT(a,b)=a##b -DSTR(a)=#a -UBAZ ' \
+		'--recurse --keepgoing --filter c,cpp,h '
+	cache = report_file('cache.txt')
+	file_del(cache)
+	single = report_file('cache.uncached.txt')
+	rc = run(coan + ' ' + cmd + config + inputs,single,os.devnull)
+	for i in (1,2):
+		cached = report_file('cache.cached.{0}.txt'.format(i))
+		cached_rc = run(coan + ' ' + cmd + config + '--expansion-cache ' +
+			cache + ' ' + inputs,cached,os.devnull)
+		if not same_run(cached_rc,cached,rc,single,'Cached','uncached'):
+			failures += 1
+
+atexit.register(exithandler)
+
+do_test('symbols --expand --explain --locate')
+do_test('symbols --once-per-file --expand')
+
+msg = '{0} out of {1} tests failed'.format(failures,testno)
+info(msg)
+
+finis(failures)
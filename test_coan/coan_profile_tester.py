@@ -0,0 +1,340 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, os, atexit, argparse, json, csv, subprocess, shlex, signal, \
+	time, re, shutil
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_profile_tester')
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Verify the trace that coan writes with --trace, the '
+		'profiles it writes with --profile-symbols, --profile-files and '
+		'--profile-files-csv, the progress reports it writes with --progress '
+		'and the run summary it writes on SIGUSR1')
+
+parser.add_argument('-v', '--verbosity', metavar='LEVEL',
+	default='progress',
+    help='Display diagnostics with severity >= LEVEL, where '
+    	'LEVEL = \'progress\', \'info\', \'warning\', \'error\' or '
+    	'\'fatal\'. Default = \'progress\'')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',
+	default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the output files at exit')
+
+args = vars(parser.parse_args())
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+set_verbosity(args['verbosity'])
+do_metrics()
+
+failures = 0
+testno = 0
+output_files = []
+keep = args['keep']
+coan = os.path.join(execdir,'coan')
+test_case = os.path.join(pkgdir,'test_coan','test_cases','test0457.c')
+other_case = os.path.join(pkgdir,'test_coan','test_cases','test0001.c')
+slow_case = 'profile.slow.c'
+
+def exithandler():
+	''' atexit() cleanup '''
+	if not keep and not failures:
+		for file in output_files:
+			file_del(file)
+
+def output_file(name):
+	''' Return the name of an output file to be deleted at exit '''
+	output_files.append(name)
+	return name
+
+def json_name(name):
+	''' Return the string that a JSON trace decodes from the bytes of the
+	filename `name`: UTF-8 if valid, else Latin-1 '''
+	try:
+		return name.decode('utf-8')
+	except UnicodeDecodeError:
+		return name.decode('latin-1')
+
+def do_trace_test(cmd,files,directives):
+	''' Run the command `cmd` with --trace on `files` and check that the
+	trace is valid JSON in Chrome trace-event format, that it has a span for
+	each file that contains all the other spans of the file and that it has
+	`directives` directive spans '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Trace test {0}: \"{1}\" ***'.format(testno,cmd))
+	trace_file = output_file('profile.trace.json')
+	run(coan + ' ' + cmd + ' --trace ' + trace_file + ' ' + ' '.join(files),
+		os.devnull,os.devnull)
+	try:
+		events = json.loads(slurp_file(trace_file))['traceEvents']
+	except (ValueError,KeyError,TypeError) as e:
+		failures += 1
+		error('*** Trace \"' + trace_file + '\" is not valid: ' + str(e))
+		return
+	spans = [event for event in events if event.get('ph') == 'X']
+	for span in spans:
+		if not 'name' in span or span.get('dur',-1) < 0 or \
+			span.get('ts',-1) < 0:
+			failures += 1
+			error('*** Invalid trace event {0}'.format(span))
+			return
+	file_spans = [span for span in spans if span.get('cat') == 'file']
+	if sorted([span['name'] for span in file_spans]) != \
+		sorted([json_name(os.path.realpath(file)) for file in files]):
+		failures += 1
+		error('*** Expected file spans for {0}, got {1}'.format(
+			files,[span['name'] for span in file_spans]))
+		return
+	count = 0
+	for span in spans:
+		if span.get('cat') == 'directive':
+			count += 1
+		if span in file_spans:
+			continue
+		# Times are rounded to the nanosecond
+		if not [outer for outer in file_spans
+			if outer['ts'] <= span['ts'] + 0.001 and
+				span['ts'] + span['dur'] <= outer['ts'] + outer['dur'] + 0.002]:
+			failures += 1
+			error('*** Trace event {0} is not within a file span'.format(span))
+	if count != directives:
+		failures += 1
+		error('*** Expected {0} directive spans, got {1}'.format(
+			directives,count))
+
+def get_table(text,title):
+	''' Return the heading of the table in `text` whose title contains
+	`title` and a list of the rows of the table, each a list of fields,
+	or None if there is no such table '''
+	lines = text.splitlines()
+	for i in range(len(lines)):
+		if lines[i].find(title) != -1:
+			rows = []
+			for line in lines[i + 2:]:
+				if not line.startswith('  '):
+					break
+				rows.append(line.split())
+			return (lines[i],rows)
+	return None
+
+def do_symbol_profile_test(cmd,top,expected,case = None):
+	''' Run the command `cmd` with --profile-symbols `top` on the test
+	case, or on `case` if given, and check that the profile lists, in order of self time, the
+	`expected` symbols, a dictionary of the digests, expansions, max bytes
+	and invalidations of each symbol keyed by name '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Symbol profile test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('profile.stderr.txt')
+	run(coan + ' ' + cmd + ' --profile-symbols ' + str(top) + ' ' +
+		(case or test_case),os.devnull,stderr_file)
+	table = get_table(slurp_file(stderr_file),' symbol profile: ')
+	if table == None:
+		failures += 1
+		error('*** No symbol profile in \"' + stderr_file + '\"')
+		return
+	(title,rows) = table
+	shown = min(top,len(expected))
+	if title.find('top {0} of {1} symbols'.format(shown,len(expected))) == -1:
+		failures += 1
+		error('*** Unexpected symbol profile title \"' + title + '\"')
+	if len(rows) != shown:
+		failures += 1
+		error('*** Expected {0} profiled symbols, got {1}'.format(
+			shown,len(rows)))
+	for row in rows:
+		if expected.get(row[0]) != row[3:]:
+			failures += 1
+			error('*** Expected {0} profile {1}, got {2}'.format(
+				row[0],expected.get(row[0]),row[3:]))
+	times = [float(row[1]) for row in rows]
+	if times != sorted(times,reverse = True):
+		failures += 1
+		error('*** Symbol profile is not in order of self time')
+
+def do_file_profile_test(cmd,files,top,expected):
+	''' Run the command `cmd` with --profile-files `top` and
+	--profile-files-csv on `files` and check that the profile lists, in
+	order of time, the top files of `expected`, a dictionary of the lines,
+	directives, expansions and bytes output for each file keyed by name,
+	and that the CSV file records all of them '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** File profile test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('profile.stderr.txt')
+	csv_file = output_file('profile.files.csv')
+	run(coan + ' ' + cmd + ' --profile-files ' + str(top) +
+		' --profile-files-csv ' + csv_file + ' ' + ' '.join(files),
+		os.devnull,stderr_file)
+	table = get_table(slurp_file(stderr_file),' file profile: ')
+	if table == None:
+		failures += 1
+		error('*** No file profile in \"' + stderr_file + '\"')
+		return
+	(title,rows) = table
+	shown = min(top,len(expected))
+	if title.find('top {0} of {1} files'.format(shown,len(expected))) == -1:
+		failures += 1
+		error('*** Unexpected file profile title \"' + title + '\"')
+	if len(rows) != shown:
+		failures += 1
+		error('*** Expected {0} profiled files, got {1}'.format(
+			shown,len(rows)))
+	for row in rows:
+		if expected.get(row[5]) != row[1:5]:
+			failures += 1
+			error('*** Expected {0} profile {1}, got {2}'.format(
+				row[5],expected.get(row[5]),row[1:5]))
+	times = [float(row[0]) for row in rows]
+	if times != sorted(times,reverse = True):
+		failures += 1
+		error('*** File profile is not in order of time')
+	with open(csv_file) as lines:
+		records = list(csv.reader(lines))
+	header = ['file','wall_s','lines','directives','expansions',
+		'bytes_written','abandoned']
+	if not records or records[0] != header:
+		failures += 1
+		error('*** Expected CSV header {0} in \"{1}\"'.format(
+			','.join(header),csv_file))
+		return
+	if sorted([record[0] for record in records[1:]]) != sorted(expected.keys()):
+		failures += 1
+		error('*** Expected CSV records for {0} in \"{1}\"'.format(
+			sorted(expected.keys()),csv_file))
+	for record in records[1:]:
+		if expected.get(record[0]) != record[2:6] or record[6] != '0' or \
+			float(record[1]) < 0:
+			failures += 1
+			error('*** Unexpected CSV record {0} in \"{1}\"'.format(
+				record,csv_file))
+
+def write_slow_case(size):
+	''' Write a test case of `size` #if directives that has to be
+	processed for long enough to be reported on '''
+	with open(output_file(slow_case),'w') as out:
+		for i in range(size):
+			out.write('#if FOO > {0}\n#endif\n'.format(i))
+
+def do_progress_test(cmd):
+	''' Run the command `cmd` with --progress-interval 1 on test cases of
+	increasing size until a run takes at least 2 seconds and check that
+	the run reports its progress '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Progress test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('profile.stderr.txt')
+	size = 100000
+	while True:
+		write_slow_case(size)
+		start = time.time()
+		run(coan + ' ' + cmd + ' --progress-interval 1 ' + slow_case,
+			os.devnull,stderr_file)
+		if time.time() - start >= 2:
+			break
+		if size >= 100000 << 6:
+			failures += 1
+			error('*** No test case was slow enough to report progress')
+			return
+		size *= 2
+	report = re.compile(r' progress: \d+ of 1 files \(\d+\.\d%\), '
+		r'[\d.]+ files/s, \d+ lines/s, [\d.]+ MB/s, '
+		r'ETA (\d+:\d\d:\d\d|unknown)$')
+	if not [line for line in slurp_file(stderr_file).splitlines()
+		if report.search(line)]:
+		failures += 1
+		error('*** No progress report in \"' + stderr_file + '\"')
+
+def do_signal_test(cmd):
+	''' Run the command `cmd` without --stats on the slow test case written
+	by `do_progress_test`, send it SIGUSR1 after a second and check that it
+	writes a run summary of the lines read so far '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Signal test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('profile.stderr.txt')
+	with open(os.devnull,'w') as out:
+		with open(stderr_file,'w') as err:
+			proc = subprocess.Popen(shlex.split(coan + ' ' + cmd + ' ' +
+				slow_case),stdout = out,stderr = err)
+			time.sleep(1)
+			proc.send_signal(signal.SIGUSR1)
+			proc.wait()
+	stats = get_stats(slurp_file(stderr_file))
+	if stats == None:
+		failures += 1
+		error('*** No run summary in \"' + stderr_file + '\"')
+	elif stats.get('lines','0') == '0':
+		failures += 1
+		error('*** Expected lines > 0 in the run summary')
+
+atexit.register(exithandler)
+
+# Every directive is traced with --trace-threshold 0
+do_trace_test('source -DFOO=1 -UBAR --trace-threshold 0',[test_case],9)
+do_trace_test('symbols -DFOO=1 -UBAR --trace-threshold 0',
+	[test_case,other_case],9 + 3)
+# A filename that is not valid UTF-8 is escaped in the trace
+latin1_case = output_file('profile.\xe9.c')
+shutil.copy(test_case,latin1_case)
+do_trace_test('source -DFOO=1 -UBAR --trace-threshold 0',[latin1_case],9)
+# X is digested and expanded once, to "((1) + 1)", and FOO within it
+symbols = {
+	'X' : ['1','1','9','1'], 'FOO' : ['1','1','1','0'],
+	'BAZ' : ['1','0','0','0']
+}
+do_symbol_profile_test('source -DFOO=1 -UBAR',5,symbols)
+do_symbol_profile_test('source -DFOO=1 -UBAR',1,symbols)
+# Nested macro-expansions are charged to their own symbols
+nested_case = output_file('profile.nested.c')
+fh = fopen(nested_case,'w')
+fh.write('#if TOP\nKEEP ME\n#endif\n')
+fh.close()
+do_symbol_profile_test('source -DTOP=MID -DMID=\'INNER(1)+INNER(2)\' ' \
+	'-D\'INNER(x)=(x*2)\'',10,{
+	'TOP' : ['1','1','11','0'], 'MID' : ['1','1','14','0'],
+	'INNER' : ['2','2','5','0']
+},nested_case)
+# Bytes output are counted for source output, not for reports
+do_file_profile_test('source -DFOO=1 -UBAR',[test_case],3,
+	{ os.path.realpath(test_case) : ['16','9','1','133'] })
+do_file_profile_test('symbols -DFOO=1 -UBAR',[test_case,other_case],1,
+	{ os.path.realpath(test_case) : ['16','9','4','0'],
+	os.path.realpath(other_case) : ['7','3','0','0'] })
+do_progress_test('source -DFOO=1')
+# SIGUSR1 is only handled on Unix-like hosts
+if not windows():
+	do_signal_test('source -DFOO=1')
+
+msg = '{0} out of {1} tests failed'.format(failures,testno)
+info(msg)
+
+finis(failures)
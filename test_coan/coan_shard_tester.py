@@ -0,0 +1,112 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, os, atexit, argparse
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_shard_tester')
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Verify that the reports of listing commands run with '
+		'--shard 1/N through --shard N/N, combined by coan merge, are '
+		'identical with the report of a single run')
+
+parser.add_argument('-v', '--verbosity', metavar='LEVEL',
+	default='progress',
+    help='Display diagnostics with severity >= LEVEL, where '
+    	'LEVEL = \'progress\', \'info\', \'warning\', \'error\' or '
+    	'\'fatal\'. Default = \'progress\'')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',
+	default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the report files at exit')
+
+args = vars(parser.parse_args())
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+set_verbosity(args['verbosity'])
+do_metrics()
+
+failures = 0
+testno = 0
+report_files = []
+keep = args['keep']
+coan = os.path.join(execdir,'coan')
+inputs = os.path.join(pkgdir,'src') + ' ' + \
+	os.path.join(pkgdir,'test_coan','test_cases')
+
+def exithandler():
+	''' atexit() cleanup '''
+	if not keep and not failures:
+		for file in report_files:
+			file_del(file)
+
+def report_file(name):
+	''' Return the name of a report file to be deleted at exit '''
+	report_files.append(name)
+	return name
+
+def do_test(cmd,shards):
+	''' Run the listing command `cmd` once over the inputs and then
+	as `shards` shards, merge the shard reports and compare the
+	merged report and exit code with those of the single run '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Shard test {0}: \"{1}\" in {2} shards ***'.format(
+		testno,cmd,shards))
+	merge_opts = ''
+	for opt in ('--once-only','--locate'):
+		if cmd.find(opt) != -1:
+			merge_opts += ' ' + opt
+	config = ' -DFOO=1 -UBAR --recurse --keepgoing --filter c,cpp,h '
+	single = report_file('shard.single.txt')
+	rc = run(coan + ' ' + cmd + config + inputs,single,os.devnull)
+	reports = []
+	codes = []
+	for i in range(1,shards + 1):
+		report = report_file('shard.{0}.txt'.format(i))
+		codes.append(str(run(coan + ' ' + cmd + config +
+			'--shard {0}/{1} '.format(i,shards) + inputs,report,os.devnull)))
+		reports.append(report)
+	merged = report_file('shard.merged.txt')
+	merged_rc = run(coan + ' merge' + merge_opts + ' --exit-codes ' +
+		','.join(codes) + ' ' + ' '.join(reports),merged)
+	if not same_run(merged_rc,merged,rc,single,'Merged','single'):
+		failures += 1
+
+atexit.register(exithandler)
+
+do_test('symbols',3)
+do_test('symbols --once-only --locate --expand',3)
+do_test('symbols --locate --expand --explain -DBAZ=FOO+1',3)
+do_test('symbols --once-per-file --locate',4)
+do_test('includes --once-only --locate',3)
+do_test('defs --once-only',5)
+do_test('defs --locate',2)
+do_test('directives --once-only',7)
+
+msg = '{0} out of {1} tests failed'.format(failures,testno)
+info(msg)
+
+finis(failures)
@@ -2,7 +2,7 @@
 
 copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
 
-import sys, os, argparse, atexit, re, string
+import sys, os, argparse, atexit, re, string, filecmp
 
 top_srcdir = os.getenv('COAN_PKGDIR')
 if not top_srcdir:
@@ -77,6 +77,7 @@ stdout_file = 'stdout.temp.txt'
 in_file_list = 'spin-test-infiles.txt'
 out_file_list = 'spin-test-outfiles.txt'
 error_file_list = 'spin-test-errorfiles.txt'
+temp_files = []
 testno = 1
 exe = 'coan.exe' if windows() else 'coan'
 gripe = 'abend 0x0100e: The spin directory cannot include or be ' \
@@ -108,6 +109,8 @@ def exithandler():
 			file_del(stdout_file)
 			file_del(in_file_list)
 			file_del(out_file_list)
+			for temp_file in temp_files:
+				file_del(temp_file)
 
 def gather_files(list,dirname,names):
 	'''
@@ -241,6 +244,208 @@ def do_test(args,verify = True, prefix = None,
 	check_test_result(testno,gripe,epitaph)
 	testno += 1
 	
+def do_index_test(configs):
+	'''
+	Run a series of spins with --index under changing configurations
+	and verify that each spin is the same as a spin without --index, that
+	files unaffected by changes of --define and --undef options are skipped
+	and that no file is skipped when any other option changes.
+
+	Arguments:
+	configs -- A list of the configuring options of successive spins
+	'''
+	global testno
+	global failures
+	del_tree(spindir)
+	args = '--keepgoing --verbose --filter ' + ','.join(filters) + ' '
+	index_file = os.path.join(spindir,'index.txt')
+	indexed = os.path.join(spindir,'indexed')
+	full = os.path.join(spindir,'full')
+	runs = 0
+	last_opts = None
+	for config in configs:
+		opts = [word for word in config.split() if word[:2] not in ('-D','-U')]
+		progress('*** Spin Test {0}: to process {1} files with --index ' \
+			'{2} ***'.format(testno,len(in_files),config))
+		update_test_size_file(len(in_files))
+		del_tree(full)
+		run(os.path.join(execdir,exe) + ' spin ' + args + config +
+			' --dir ' + full + ' ' + ' '.join(in_dirs),
+			stdout_file,stderr_file)
+		run(os.path.join(execdir,exe) + ' spin ' + args + config +
+			' --index ' + index_file + ' --dir ' + indexed + ' ' +
+			' '.join(in_dirs),stdout_file,stderr_file)
+		progress('*** Done Test {0} ***'.format(testno))
+		skipped = slurp_file(stderr_file).count('Skipping unaffected file')
+		full_files = []
+		os.path.walk(full,gather_files,full_files)
+		mismatches = 0
+		for full_file in full_files:
+			indexed_file = os.path.join(indexed,
+				os.path.relpath(full_file,full))
+			if not os.path.exists(indexed_file) or \
+				not filecmp.cmp(full_file,indexed_file,False):
+				mismatches += 1
+		if not full_files or mismatches or \
+			(runs and (opts == last_opts) != (skipped > 0)):
+			error('*** Spin test {0}: Failed! {1} of {2} files differ, ' \
+				'{3} files skipped ****'.format(testno,mismatches,
+					len(full_files),skipped))
+			failures += 1
+			if bail:
+				sys.exit(failures)
+		runs += 1
+		last_opts = opts
+		testno += 1
+
+def do_compile_db_test(configs,common = ''):
+	'''
+	Run a spin of the input files configured by a compilation database
+	and verify that the spin of each file is the same as when it is spun
+	alone under its configuration.
+
+	Arguments:
+	configs -- A list of the compiler options of the configurations,
+	assigned to the input files in rotation. A configuration may be
+	a pair of its compiler options and the equivalent options for
+	spinning alone.
+	common -- Options for the commandline of the compilation database
+	spin, which the compiler options override.
+	'''
+	global testno
+	global failures
+	del_tree(spindir)
+	args = '--keepgoing --verbose '
+	solos = [config[1] if isinstance(config,tuple) else
+		config.replace('-D FOO ','-D FOO=1 ') for config in configs]
+	configs = [config[0] if isinstance(config,tuple) else config
+		for config in configs]
+	compile_db = 'spin-test-compile-db.json'
+	temp_files.append(compile_db)
+	fh = fopen(compile_db,'w')
+	fh.write('[\n')
+	for i, in_file in enumerate(in_files):
+		fh.write('{0}{{ "directory": "{1}", "file": "{2}", ' \
+			'"command": "cc {3} -c {2}" }}\n'.format(',' if i else ' ',
+				os.path.dirname(in_file),os.path.basename(in_file),
+				configs[i % len(configs)]))
+	fh.write(']\n')
+	fh.close()
+	for i, solo in enumerate(solos):
+		run(os.path.join(execdir,exe) + ' spin ' + args + solo + ' --dir ' +
+			os.path.join(spindir,'solo',str(i)) + ' ' +
+			' '.join(in_files[i::len(configs)]),stdout_file,stderr_file)
+	progress('*** Spin Test {0}: to process {1} files under {2} ' \
+		'configurations from a compilation database ***'.format(testno,
+			len(in_files),len(configs)))
+	update_test_size_file(len(in_files))
+	run(os.path.join(execdir,exe) + ' spin ' + args + common +
+		' --compile-db ' + compile_db + ' --dir ' + os.path.join(spindir,'all'),
+		stdout_file,stderr_file)
+	progress('*** Done Test {0} ***'.format(testno))
+	mismatches = 0
+	for i, in_file in enumerate(in_files):
+		rel = os.path.relpath(os.path.realpath(in_file),os.sep)
+		solo_file = os.path.join(spindir,'solo',str(i % len(configs)),rel)
+		all_file = os.path.join(spindir,'all',rel)
+		if os.path.exists(solo_file) != os.path.exists(all_file) or \
+			(os.path.exists(solo_file) and
+				not filecmp.cmp(solo_file,all_file,False)):
+			mismatches += 1
+	if mismatches:
+		error('*** Spin test {0}: Failed! {1} of {2} files differ ' \
+			'****'.format(testno,mismatches,len(in_files)))
+		failures += 1
+		if bail:
+			sys.exit(failures)
+	testno += 1
+
+def do_config_test(config):
+	'''
+	Precompile a configuration and verify that a spin under the
+	precompiled configuration is the same as a spin under its options.
+
+	Arguments:
+	config -- The configuring options
+	'''
+	global testno
+	global failures
+	del_tree(spindir)
+	args = '--keepgoing --verbose --filter ' + ','.join(filters) + ' '
+	cfg_file = 'spin-test-config.bin'
+	temp_files.append(cfg_file)
+	run(os.path.join(execdir,exe) + ' precompile-config ' + config + ' ' +
+		cfg_file,stdout_file,stderr_file)
+	run(os.path.join(execdir,exe) + ' spin ' + args + config +
+		' --dir ' + os.path.join(spindir,'options') + ' ' +
+		' '.join(in_dirs),stdout_file,stderr_file)
+	progress('*** Spin Test {0}: to process {1} files under a ' \
+		'precompiled configuration ***'.format(testno,len(in_files)))
+	update_test_size_file(len(in_files))
+	run(os.path.join(execdir,exe) + ' spin ' + args + '--config ' +
+		cfg_file + ' --dir ' + os.path.join(spindir,'config') + ' ' +
+		' '.join(in_dirs),stdout_file,stderr_file)
+	progress('*** Done Test {0} ***'.format(testno))
+	compare_spins(os.path.join(spindir,'options'),
+		os.path.join(spindir,'config'))
+
+def do_config_header_test(header,config):
+	'''
+	Verify that a spin under a configuration header is the same as a spin
+	under the equivalent options.
+
+	Arguments:
+	header -- The lines of the configuration header
+	config -- The configuring options equivalent to the header
+	'''
+	del_tree(spindir)
+	args = '--keepgoing --verbose --filter ' + ','.join(filters) + ' '
+	header_file = 'spin-test-config.h'
+	temp_files.append(header_file)
+	fh = fopen(header_file,'w')
+	fh.write('\n'.join(header) + '\n')
+	fh.close()
+	run(os.path.join(execdir,exe) + ' spin ' + args + config +
+		' --dir ' + os.path.join(spindir,'options') + ' ' +
+		' '.join(in_dirs),stdout_file,stderr_file)
+	progress('*** Spin Test {0}: to process {1} files under a ' \
+		'configuration header ***'.format(testno,len(in_files)))
+	update_test_size_file(len(in_files))
+	run(os.path.join(execdir,exe) + ' spin ' + args + '--config-header ' +
+		header_file + ' --dir ' + os.path.join(spindir,'header') + ' ' +
+		' '.join(in_dirs),stdout_file,stderr_file)
+	progress('*** Done Test {0} ***'.format(testno))
+	compare_spins(os.path.join(spindir,'options'),
+		os.path.join(spindir,'header'))
+
+def compare_spins(expected,actual):
+	'''
+	Verify that the files spun into one directory are the same as those
+	spun into another.
+
+	Arguments:
+	expected -- The directory of expected files
+	actual -- The directory of actual files
+	'''
+	global testno
+	global failures
+	expected_files = []
+	os.path.walk(expected,gather_files,expected_files)
+	mismatches = 0
+	for expected_file in expected_files:
+		actual_file = os.path.join(actual,
+			os.path.relpath(expected_file,expected))
+		if not os.path.exists(actual_file) or \
+			not filecmp.cmp(expected_file,actual_file,False):
+			mismatches += 1
+	if not expected_files or mismatches:
+		error('*** Spin test {0}: Failed! {1} of {2} files differ ' \
+			'****'.format(testno,mismatches,len(expected_files)))
+		failures += 1
+		if bail:
+			sys.exit(failures)
+	testno += 1
+
 atexit.register(exithandler)
 
 file_del(in_file_list)
@@ -295,4 +500,29 @@ do_test('--keepgoing -DWINDOWS --verbose --filter ' +
 	','.join(filters) + ' --dir ' + bad_dir + ' ' + spindir,
 	False,None,gripe,epitaph)
 
+# Testing spins that skip files unaffected by configuration changes
+do_index_test(['-DWINDOWS -DFOO=1','-DWINDOWS -DFOO=2',
+	'-DWINDOWS -DFOO=2 -UUNIX','-UWINDOWS -DFOO=2 -UUNIX',
+	'-UWINDOWS -DFOO=2 -UUNIX','-UWINDOWS -DFOO=2 -UUNIX --line',
+	'-UWINDOWS -DFOO=2 -UUNIX --discard comment',
+	'-UWINDOWS -DFOO=3 -UUNIX --discard comment',
+	'-UWINDOWS -DFOO=3 -UUNIX --discard comment --conflict delete'])
+
+# Testing spins of files configured by a compilation database
+if not windows():
+	do_compile_db_test(['-DWINDOWS=1 -DFOO=1','-D FOO -UWINDOWS',
+		'-DUNIX=1 -DBAR=2'])
+	do_compile_db_test([('-UWINDOWS -D WINDOWS=2 -DFOO=1 -DFOO=0 -D BAR',
+			'-DWINDOWS=2 -DFOO=0 -DBAR=1 -DUNIX=1'),
+		('-DUNIX=1 -UUNIX','-DBAR -UUNIX')],'-DBAR -DUNIX=1')
+
+# Testing spins under a precompiled configuration
+do_config_test('-DWINDOWS -DFOO=1 -DBAR(x,y)=x##y -DBAZ=FOO+BAR -UUNIX')
+
+# Testing spins under a configuration header
+do_config_header_test(['/* Generated */','#ifndef CONFIG_H','#define WINDOWS',
+	'#define FOO 1 // comment','# define BAR(x,y) \\','\tx##y',
+	'#define BAZ FOO+BAR /* comment */','#undef UNIX','#endif'],
+	'-DWINDOWS -DFOO=1 -DBAR(x,y)=x##y -DBAZ=FOO+BAR -UUNIX')
+
 finis(failures)
@@ -0,0 +1,125 @@
+#!/usr/bin/python
+
+copyright = 'Copyright (c) 2012-2013 Michael Kinghan'
+
+import sys, os, atexit, argparse
+
+top_srcdir = os.getenv('COAN_PKGDIR')
+if not top_srcdir:
+	top_srcdir = os.pardir
+
+sys.path.append(os.path.join(top_srcdir,'python'))
+
+from coanlib import *
+
+set_prog('coan_stats_tester')
+
+parser = argparse.ArgumentParser(
+	prog=get_prog(),
+    formatter_class=argparse.RawDescriptionHelpFormatter,
+    description='Verify the run summary that coan writes with --stats')
+
+parser.add_argument('-v', '--verbosity', metavar='LEVEL',
+	default='progress',
+    help='Display diagnostics with severity >= LEVEL, where '
+    	'LEVEL = \'progress\', \'info\', \'warning\', \'error\' or '
+    	'\'fatal\'. Default = \'progress\'')
+
+parser.add_argument('-p', '--pkgdir', metavar='PKGDIR',
+    help='PKGDIR is the coan package directory. '
+    'Default is value of environment variable COAN_PKGDIR is defined, '
+    'else \"..\"')
+
+parser.add_argument('-e', '--execdir', metavar='EXECDIR',
+	default='src',
+    help='EXECDIR is the directory beneath '
+		'PKGDIR from which to run coan: Default \"src\"')
+
+parser.add_argument('-k', '--keep', action='store_true',
+	default=False,
+    help='Do not delete the output files at exit')
+
+args = vars(parser.parse_args())
+pkgdir = deduce_pkgdir(args)
+execdir = deduce_execdir(args)
+set_verbosity(args['verbosity'])
+do_metrics()
+
+failures = 0
+testno = 0
+output_files = []
+keep = args['keep']
+coan = os.path.join(execdir,'coan')
+test_case = os.path.join(pkgdir,'test_coan','test_cases','test0457.c')
+
+def exithandler():
+	''' atexit() cleanup '''
+	if not keep and not failures:
+		for file in output_files:
+			file_del(file)
+
+def output_file(name):
+	''' Return the name of an output file to be deleted at exit '''
+	output_files.append(name)
+	return name
+
+def do_test(cmd,expected):
+	''' Run the command `cmd` with --stats on the test case and check
+	that the run summary contains the `expected` items and that its times
+	are consistent '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Stats test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('stats.stderr.txt')
+	run(coan + ' ' + cmd + ' --stats ' + test_case,os.devnull,stderr_file)
+	stats = get_stats(slurp_file(stderr_file))
+	if stats == None:
+		failures += 1
+		error('*** No run summary in \"' + stderr_file + '\"')
+		return
+	for name in sorted(expected.keys()):
+		if stats.get(name) != expected[name]:
+			failures += 1
+			error('*** Expected {0} = {1}, got {2}'.format(
+				name,expected[name],stats.get(name)))
+	wall = float(stats['time.total.wall_s'])
+	# clock() ticks may overshoot the wall clock by a tick per phase
+	for name in ('time.total.cpu_s','time.other.cpu_s'):
+		if float(stats[name]) > wall + 0.01:
+			failures += 1
+			error('*** {0} = {1} exceeds time.total.wall_s = {2}'.format(
+				name,stats[name],wall))
+
+def do_off_test(cmd):
+	''' Run the command `cmd` without --stats on the test case and check
+	that no run summary is written '''
+	global testno
+	global failures
+	testno += 1
+	progress('*** Stats test {0}: \"{1}\" ***'.format(testno,cmd))
+	stderr_file = output_file('stats.stderr.txt')
+	run(coan + ' ' + cmd + ' ' + test_case,os.devnull,stderr_file)
+	if get_stats(slurp_file(stderr_file)) != None:
+		failures += 1
+		error('*** Unexpected run summary in \"' + stderr_file + '\"')
+
+atexit.register(exithandler)
+
+counts = {
+	'lines' : '16', 'directives' : '9', 'directives.if' : '2',
+	'directives.ifdef' : '1', 'directives.else' : '1',
+	'directives.elif' : '1', 'directives.endif' : '3',
+	'directives.define' : '1', 'ifs.resolved' : '2',
+	'ifs.unresolved' : '2', 'symbols.global' : '2'
+}
+do_test('source -DFOO=1 -UBAR',counts)
+# Lines skimmed by a directives-only command are counted too
+do_test('includes -DFOO=1 -UBAR',{ 'lines' : '16', 'directives' : '9' })
+do_test('symbols -DFOO=1 -UBAR',counts)
+do_off_test('source -DFOO=1 -UBAR')
+
+msg = '{0} out of {1} tests failed'.format(failures,testno)
+info(msg)
+
+finis(failures)
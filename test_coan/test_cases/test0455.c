@@ -0,0 +1,19 @@
+/**ARGS: directives --locate */
+/**SYSCODE: = 0 */
+int a;
+int b = 1 + 2;
+
+/* A comment spanning lines
+#include "not_a_directive.h"
+*/
+char const * s = "\
+#define NOT_A_DIRECTIVE";
+int c; /* comment
+#error Not a directive */
+#include <stdio.h>
+int d;
+	int e;
+  # include "x.h"
+int f; // comment \
+#undef NOT_A_DIRECTIVE
+#pragma once
@@ -0,0 +1,15 @@
+/**ARGS: source --max-expansion 40 */
+/**SYSCODE: = 1 | 2 | 16 */
+#define A (1 + 1 + 1 + 1)
+#define B (A + A)
+#define C (B + B)
+#if B
+KEEP ME
+#else
+DROP ME
+#endif
+#if C
+KEEP ME
+#else
+KEEP ME
+#endif
@@ -0,0 +1,16 @@
+/**ARGS: source --stats -DFOO=1 -UBAR */
+/**SYSCODE: = 1 | 2 | 16 */
+#define X(a) ((a) + FOO)
+#ifdef FOO
+KEEP ME
+#else
+DROP ME
+#endif
+#if X(1) && !defined(BAR)
+KEEP ME
+#elif BAZ
+DROP ME
+#endif
+#if BAZ
+KEEP ME
+#endif
@@ -0,0 +1,19 @@
+/**ARGS: source -DFOO --expansion-budget 1 */
+/**SYSCODE: = 1 | 2 | 16 */
+#define A(x) (x+1)
+#if A(1) == 2
+K1
+#endif
+#if A(2) == 3
+K2
+#endif
+#ifdef FOO
+K3
+#else
+K4
+#endif
+#if A(3) == 4
+K5
+#elif A(4)
+K6
+#endif
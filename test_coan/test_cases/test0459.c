@@ -0,0 +1,9 @@
+/**ARGS: symbols --select SEL_B,SEL_*,SEL_C */
+/**SYSCODE: = 0 */
+#if defined(SEL_A) || defined(SEL_B)
+KEEP ME
+#elif defined SEL_D || defined OTHER
+KEEP ME
+#elif SEL_ || SEL
+KEEP ME
+#endif
@@ -0,0 +1,19 @@
+/**ARGS: source -DFOO --expansion-budget 100 */
+/**SYSCODE: = 1 | 2 | 16 */
+#define F0(x) (x)
+#define F1(x) (F0(x) + F0(x+1))
+#define F2(x) (F1(x) + F1(x+2))
+#define F3(x) (F2(x) + F2(x+4))
+#define F4(x) (F3(x) + F3(x+8))
+#define F5(x) (F4(x) + F4(x+16))
+#define F6(x) (F5(x) + F5(x+32))
+#define F7(x) (F6(x) + F6(x+64))
+#if F1(0) == 1
+K1
+#endif
+#if F7(0) == 8128
+K2
+#endif
+#ifdef FOO
+K3
+#endif
@@ -0,0 +1,6 @@
+/**ARGS: source --max-expansion 17592186044417M */
+/**SYSCODE: = 4 */
+/**NO-OUTPUT */
+#if FOO
+KEEP ME
+#endif